@@ -0,0 +1,329 @@
+// Benchmarks of the public S21Matrix operations over square sizes from 2 to
+// 2048, plus the sparse and Strassen-Winograd products. Every benchmark
+// reports the bytes it has to move at least (bytes_per_second) and, where
+// it does arithmetic, the floating-point operations (FLOPS, both per
+// second). Built and run by `make bench`; see benchmarks/compare.py.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../s21_matrix_oop.h"
+
+namespace {
+
+constexpr int kMinSize = 2;
+constexpr int kMaxSize = 2048;
+
+// diagonally dominant when square, so every size has an inverse
+S21Matrix Filled(int rows, int cols, int seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      m(i, j) = ((i * 31 + j * 17 + seed) % 23) * 0.25 - 2 +
+                (i == j) * 2.0 * cols;
+  return m;
+}
+
+S21Matrix Filled(int n, int seed) { return Filled(n, n, seed); }
+
+double Square(benchmark::State& state) {
+  const double n = static_cast<double>(state.range(0));
+  return n * n;
+}
+
+// per-iteration work of the benchmark
+void Report(benchmark::State& state, double flops, double bytes) {
+  if (flops > 0) {
+    state.counters["FLOPS"] = benchmark::Counter(
+        flops, benchmark::Counter::kIsIterationInvariantRate);
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(
+      bytes * static_cast<double>(state.iterations())));
+}
+
+void Sizes(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(2)
+      ->Range(kMinSize, kMaxSize)
+      ->Unit(benchmark::kMicrosecond);
+}
+
+// construction, copy and move
+
+void BM_Construct(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    S21Matrix m(n, n);
+    benchmark::DoNotOptimize(m.Data());
+  }
+  Report(state, 0, 8 * Square(state));
+}
+BENCHMARK(BM_Construct)->Apply(Sizes);
+
+void BM_Copy(benchmark::State& state) {
+  const S21Matrix a = Filled(static_cast<int>(state.range(0)), 1);
+  for (auto _ : state) {
+    S21Matrix m(a);
+    benchmark::DoNotOptimize(m.Data());
+  }
+  Report(state, 0, 16 * Square(state));
+}
+BENCHMARK(BM_Copy)->Apply(Sizes);
+
+void BM_Move(benchmark::State& state) {
+  S21Matrix a = Filled(static_cast<int>(state.range(0)), 1);
+  for (auto _ : state) {
+    S21Matrix m(std::move(a));
+    a = std::move(m);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  Report(state, 0, 0);
+}
+BENCHMARK(BM_Move)->Apply(Sizes);
+
+// elementwise operations
+
+void BM_SumMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, 1);
+  const S21Matrix b = Filled(n, 2);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  Report(state, Square(state), 24 * Square(state));
+}
+BENCHMARK(BM_SumMatrix)->Apply(Sizes);
+
+void BM_SubMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, 1);
+  const S21Matrix b = Filled(n, 2);
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  Report(state, Square(state), 24 * Square(state));
+}
+BENCHMARK(BM_SubMatrix)->Apply(Sizes);
+
+void BM_MulNumber(benchmark::State& state) {
+  const S21Matrix a = Filled(static_cast<int>(state.range(0)), 1);
+  for (auto _ : state) {
+    // alternating factors keep the elements from drifting off
+    a.MulNumber(2.0);
+    a.MulNumber(0.5);
+    benchmark::ClobberMemory();
+  }
+  Report(state, 2 * Square(state), 32 * Square(state));
+}
+BENCHMARK(BM_MulNumber)->Apply(Sizes);
+
+void BM_EqMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix a = Filled(n, 1);
+  const S21Matrix b(a);
+  for (auto _ : state) benchmark::DoNotOptimize(a.EqMatrix(b));
+  Report(state, Square(state), 16 * Square(state));
+}
+BENCHMARK(BM_EqMatrix)->Apply(Sizes);
+
+// products
+
+void BM_MulMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix a = Filled(n, 1);
+  const S21Matrix b = Filled(n, 2);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(c.Data());
+  }
+  Report(state, 2 * Square(state) * n, 24 * Square(state));
+}
+BENCHMARK(BM_MulMatrix)->Apply(Sizes);
+
+// 7/8 of the classical operation count per level; FLOPS stays the
+// classical 2 n^3 so the numbers compare with BM_MulMatrix
+void BM_MulMatrixStrassen(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix a = Filled(n, 1);
+  const S21Matrix b = Filled(n, 2);
+  const int threshold = S21Strassen::GetThreshold();
+  S21Strassen::SetThreshold(1);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c.Data());
+  }
+  S21Strassen::SetThreshold(threshold);
+  Report(state, 2 * Square(state) * n, 24 * Square(state));
+}
+BENCHMARK(BM_MulMatrixStrassen)
+    ->RangeMultiplier(2)
+    ->Range(512, kMaxSize)
+    ->Unit(benchmark::kMicrosecond);
+
+// transposition
+
+void BM_Transpose(benchmark::State& state) {
+  const S21Matrix a = Filled(static_cast<int>(state.range(0)), 1);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t.Data());
+  }
+  Report(state, 0, 16 * Square(state));
+}
+BENCHMARK(BM_Transpose)->Apply(Sizes);
+
+void BM_TransposeInPlace(benchmark::State& state) {
+  S21Matrix a = Filled(static_cast<int>(state.range(0)), 1);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::ClobberMemory();
+  }
+  Report(state, 0, 16 * Square(state));
+}
+BENCHMARK(BM_TransposeInPlace)->Apply(Sizes);
+
+// factorization-based operations
+
+void BM_Determinant(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix a = Filled(n, 1);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+  Report(state, 2.0 / 3 * Square(state) * n, 16 * Square(state));
+}
+BENCHMARK(BM_Determinant)->Apply(Sizes);
+
+void BM_InverseMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix a = Filled(n, 1);
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.Data());
+  }
+  Report(state, 2 * Square(state) * n, 24 * Square(state));
+}
+BENCHMARK(BM_InverseMatrix)->Apply(Sizes);
+
+// one determinant of order n - 1 per element, O(n^5): stops at 64
+void BM_CalcComplements(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix a = Filled(n, 1);
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements.Data());
+  }
+  const double minor = n - 1;
+  Report(state, Square(state) * 2.0 / 3 * minor * minor * minor,
+         Square(state) * 16 * minor * minor);
+}
+BENCHMARK(BM_CalcComplements)
+    ->RangeMultiplier(2)
+    ->Range(kMinSize, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+// resizing: drop half the rows (columns) and grow back, which zero-fills
+// them; new columns also restride every row
+
+void BM_SetRows(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, 1);
+  for (auto _ : state) {
+    a.SetRows(n / 2);
+    a.SetRows(n);
+    benchmark::ClobberMemory();
+  }
+  Report(state, 0, 4 * Square(state));
+}
+BENCHMARK(BM_SetRows)->Apply(Sizes);
+
+void BM_SetCols(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = Filled(n, 1);
+  for (auto _ : state) {
+    a.SetCols(n / 2);
+    a.SetCols(n);
+    benchmark::ClobberMemory();
+  }
+  Report(state, 0, 24 * Square(state));
+}
+BENCHMARK(BM_SetCols)->Apply(Sizes);
+
+// sparse products; arguments are the order and the density in per mille
+
+S21SparseMatrix Sparse(int n, int per_mille, int seed) {
+  std::vector<S21SparseMatrix::Triplet> triplets;
+  std::uint32_t state = 2463534242u + seed;
+  const std::uint64_t count =
+      static_cast<std::uint64_t>(n) * n * per_mille / 1000;
+  for (std::uint64_t t = 0; t < count; t++) {
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    const std::uint64_t at = state % (static_cast<std::uint64_t>(n) * n);
+    triplets.push_back({static_cast<int>(at / n), static_cast<int>(at % n),
+                        (state % 1000) * 1e-3 - 0.5});
+  }
+  return S21SparseMatrix::FromTriplets(n, n, triplets);
+}
+
+void SparseArgs(benchmark::internal::Benchmark* b) {
+  for (int n : {1000, 4000}) {
+    for (int per_mille : {1, 10}) b->Args({n, per_mille});
+  }
+  b->Unit(benchmark::kMicrosecond);
+}
+
+// 12 bytes per stored element (value and index) plus the vectors
+void BM_SparseMulVector(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21SparseMatrix a = Sparse(n, static_cast<int>(state.range(1)), 1);
+  const std::vector<double> x(n, 1.0);
+  for (auto _ : state) {
+    std::vector<double> y = a.MulVector(x);
+    benchmark::DoNotOptimize(y.data());
+  }
+  Report(state, 2.0 * a.NonZeros(), 12.0 * a.NonZeros() + 16.0 * n);
+}
+BENCHMARK(BM_SparseMulVector)->Apply(SparseArgs);
+
+// a multiply-add for every stored a_ik and every stored b_kj of row k
+void BM_SparseMulMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const int per_mille = static_cast<int>(state.range(1));
+  const S21SparseMatrix a = Sparse(n, per_mille, 1);
+  const S21SparseMatrix b = Sparse(n, per_mille, 2);
+  double products = 0;
+  for (int k : a.Indices()) {
+    products += b.Offsets()[k + 1] - b.Offsets()[k];
+  }
+  std::int64_t stored = 0;
+  for (auto _ : state) {
+    S21SparseMatrix c = a * b;
+    stored = c.NonZeros();
+    benchmark::DoNotOptimize(stored);
+  }
+  Report(state, 2 * products,
+         12.0 * (a.NonZeros() + b.NonZeros() + static_cast<double>(stored)));
+}
+BENCHMARK(BM_SparseMulMatrix)->Apply(SparseArgs);
+
+void BM_SparseTimesDense(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21SparseMatrix a = Sparse(n, static_cast<int>(state.range(1)), 1);
+  const S21Matrix b = Filled(n, 64, 2);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c.Data());
+  }
+  Report(state, 2.0 * a.NonZeros() * 64, 12.0 * a.NonZeros() + 1024.0 * n);
+}
+BENCHMARK(BM_SparseTimesDense)->Apply(SparseArgs);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON files, e.g. a stored baseline and a
+fresh `make bench` run, and exits with status 1 when any benchmark present
+in both got slower than the baseline by more than the threshold.
+
+    compare.py baseline.json current.json [--threshold 0.10]
+
+CPU time is compared. Files written with --benchmark_repetitions are
+compared on their medians.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as source:
+        runs = json.load(source)["benchmarks"]
+    medians = {r["run_name"] for r in runs
+               if r.get("aggregate_name") == "median"}
+    times = {}
+    for run in runs:
+        name = run.get("run_name", run["name"])
+        if name in medians:
+            if run.get("aggregate_name") != "median":
+                continue
+        elif run.get("run_type") == "aggregate":
+            continue
+        times[name] = float(run["cpu_time"])
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="largest allowed slowdown, 0.10 is 10%%")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    shared = [name for name in baseline if name in current]
+    print(f"{'benchmark':48} {'baseline':>14} {'current':>14} {'change':>8}")
+    for name in shared:
+        change = current[name] / baseline[name] - 1 if baseline[name] else 0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:48} {baseline[name]:14.3f} {current[name]:14.3f} "
+              f"{change:+8.1%}{flag}")
+    print(f"{regressions} of {len(shared)} "
+          f"benchmarks slower by more than {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
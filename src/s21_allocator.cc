@@ -0,0 +1,184 @@
+#include "s21_allocator.h"
+
+#include <new>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+class SystemAllocator : public S21MatrixAllocator {
+ protected:
+  void* DoAllocate(std::size_t bytes) override { return SystemAllocate(bytes); }
+  void DoDeallocate(void* ptr, std::size_t) noexcept override {
+    SystemDeallocate(ptr);
+  }
+};
+
+thread_local S21MatrixAllocator* current_allocator = nullptr;
+
+std::size_t RoundUp(std::size_t bytes) {
+  return (bytes + S21Matrix::kAlignment - 1) / S21Matrix::kAlignment *
+         S21Matrix::kAlignment;
+}
+
+// smallest class c with 64 << c >= bytes
+int SizeClass(std::size_t bytes) {
+  int c = 0;
+  while ((static_cast<std::size_t>(S21Matrix::kAlignment) << c) < bytes) c++;
+  return c;
+}
+
+}  // namespace
+
+// S21MatrixAllocator
+
+void* S21MatrixAllocator::Allocate(std::size_t bytes) {
+  void* ptr = DoAllocate(bytes);
+  s21::kernels::CountAllocation(bytes);
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  bytes_in_use_.fetch_add(bytes, std::memory_order_relaxed);
+  return ptr;
+}
+
+void S21MatrixAllocator::Deallocate(void* ptr, std::size_t bytes) noexcept {
+  if (ptr == nullptr) return;
+  DoDeallocate(ptr, bytes);
+  deallocations_.fetch_add(1, std::memory_order_relaxed);
+  bytes_in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+S21AllocatorStats S21MatrixAllocator::Stats() const noexcept {
+  return {allocations_.load(std::memory_order_relaxed),
+          deallocations_.load(std::memory_order_relaxed),
+          system_allocations_.load(std::memory_order_relaxed),
+          bytes_in_use_.load(std::memory_order_relaxed)};
+}
+
+void S21MatrixAllocator::ResetStats() noexcept {
+  allocations_.store(0, std::memory_order_relaxed);
+  deallocations_.store(0, std::memory_order_relaxed);
+  system_allocations_.store(0, std::memory_order_relaxed);
+}
+
+void* S21MatrixAllocator::SystemAllocate(std::size_t bytes) {
+  void* ptr = ::operator new(bytes, std::align_val_t(S21Matrix::kAlignment));
+  system_allocations_.fetch_add(1, std::memory_order_relaxed);
+  return ptr;
+}
+
+void S21MatrixAllocator::SystemDeallocate(void* ptr) noexcept {
+  ::operator delete(ptr, std::align_val_t(S21Matrix::kAlignment));
+}
+
+S21MatrixAllocator& S21DefaultAllocator() noexcept {
+  static SystemAllocator allocator;
+  return allocator;
+}
+
+S21MatrixAllocator& S21CurrentAllocator() noexcept {
+  return current_allocator != nullptr ? *current_allocator
+                                      : S21DefaultAllocator();
+}
+
+// S21PoolAllocator
+
+S21PoolAllocator::S21PoolAllocator(std::size_t max_cached_bytes)
+    : cached_bytes_(0), max_cached_bytes_(max_cached_bytes) {}
+
+S21PoolAllocator::~S21PoolAllocator() { Trim(); }
+
+void S21PoolAllocator::Trim() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& list : free_) {
+    for (void* ptr : list) SystemDeallocate(ptr);
+    list.clear();
+  }
+  cached_bytes_ = 0;
+}
+
+void* S21PoolAllocator::DoAllocate(std::size_t bytes) {
+  const int c = SizeClass(bytes);
+  if (c >= kClasses) return SystemAllocate(bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_[c].empty()) {
+      void* ptr = free_[c].back();
+      free_[c].pop_back();
+      cached_bytes_ -= static_cast<std::size_t>(S21Matrix::kAlignment) << c;
+      return ptr;
+    }
+  }
+  return SystemAllocate(static_cast<std::size_t>(S21Matrix::kAlignment) << c);
+}
+
+void S21PoolAllocator::DoDeallocate(void* ptr, std::size_t bytes) noexcept {
+  const int c = SizeClass(bytes);
+  const std::size_t block = static_cast<std::size_t>(S21Matrix::kAlignment)
+                            << c;
+  if (c < kClasses) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cached_bytes_ + block <= max_cached_bytes_) {
+      try {
+        free_[c].push_back(ptr);
+        cached_bytes_ += block;
+        return;
+      } catch (const std::bad_alloc&) {
+        // no room to remember the block: hand it back instead
+      }
+    }
+  }
+  SystemDeallocate(ptr);
+}
+
+// S21ArenaAllocator
+
+S21ArenaAllocator::S21ArenaAllocator(std::size_t chunk_bytes)
+    : current_(0), offset_(0), chunk_bytes_(RoundUp(chunk_bytes)) {}
+
+S21ArenaAllocator::~S21ArenaAllocator() {
+  for (const Chunk& chunk : chunks_) SystemDeallocate(chunk.data);
+}
+
+void S21ArenaAllocator::Reset() noexcept {
+  current_ = 0;
+  offset_ = 0;
+}
+
+std::size_t S21ArenaAllocator::Reserved() const noexcept {
+  std::size_t total = 0;
+  for (const Chunk& chunk : chunks_) total += chunk.size;
+  return total;
+}
+
+void* S21ArenaAllocator::DoAllocate(std::size_t bytes) {
+  bytes = RoundUp(bytes);
+  while (current_ < chunks_.size()) {
+    Chunk& chunk = chunks_[current_];
+    if (chunk.size - offset_ >= bytes) {
+      void* ptr = chunk.data + offset_;
+      offset_ += bytes;
+      return ptr;
+    }
+    current_++;
+    offset_ = 0;
+  }
+  const std::size_t size = bytes > chunk_bytes_ ? bytes : chunk_bytes_;
+  chunks_.reserve(chunks_.size() + 1);
+  Chunk chunk{static_cast<char*>(SystemAllocate(size)), size};
+  chunks_.push_back(chunk);
+  current_ = chunks_.size() - 1;
+  offset_ = bytes;
+  return chunk.data;
+}
+
+void S21ArenaAllocator::DoDeallocate(void*, std::size_t) noexcept {}
+
+// S21AllocatorScope
+
+S21AllocatorScope::S21AllocatorScope(S21MatrixAllocator& allocator) noexcept
+    : previous_(current_allocator) {
+  current_allocator = &allocator;
+}
+
+S21AllocatorScope::~S21AllocatorScope() { current_allocator = previous_; }
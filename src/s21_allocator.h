@@ -0,0 +1,116 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_ALLOCATOR_H
+#define CPP1_S21_MATRIXPLUS_S21_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+struct S21AllocatorStats {
+  std::size_t allocations;         // buffers handed out
+  std::size_t deallocations;       // buffers given back
+  std::size_t system_allocations;  // requests forwarded to operator new
+  std::size_t bytes_in_use;        // bytes handed out and not given back
+};
+
+// Source of matrix storage. Every S21Matrix remembers the allocator its
+// buffer came from and returns it there, so an allocator must outlive the
+// matrices it served. Buffers are aligned to S21Matrix::kAlignment.
+class S21MatrixAllocator {
+ public:
+  virtual ~S21MatrixAllocator() = default;
+
+  void* Allocate(std::size_t bytes);
+  void Deallocate(void* ptr, std::size_t bytes) noexcept;
+  S21AllocatorStats Stats() const noexcept;
+  void ResetStats() noexcept;
+
+ protected:
+  virtual void* DoAllocate(std::size_t bytes) = 0;
+  virtual void DoDeallocate(void* ptr, std::size_t bytes) noexcept = 0;
+  // aligned operator new / delete, counted as system allocations
+  void* SystemAllocate(std::size_t bytes);
+  static void SystemDeallocate(void* ptr) noexcept;
+
+ private:
+  std::atomic<std::size_t> allocations_{0};
+  std::atomic<std::size_t> deallocations_{0};
+  std::atomic<std::size_t> system_allocations_{0};
+  std::atomic<std::size_t> bytes_in_use_{0};
+};
+
+// Plain operator new / delete; used when no S21AllocatorScope is active.
+S21MatrixAllocator& S21DefaultAllocator() noexcept;
+// The allocator new matrices on the current thread draw from.
+S21MatrixAllocator& S21CurrentAllocator() noexcept;
+
+// Recycles freed buffers by power-of-two size class, so that matrices of a
+// recurring shape stop reaching the system allocator once warmed up.
+// Thread-safe; at most max_cached_bytes are kept in the free lists.
+class S21PoolAllocator : public S21MatrixAllocator {
+ public:
+  explicit S21PoolAllocator(std::size_t max_cached_bytes = 256u << 20);
+  ~S21PoolAllocator() override;
+  S21PoolAllocator(const S21PoolAllocator&) = delete;
+  S21PoolAllocator& operator=(const S21PoolAllocator&) = delete;
+
+  // gives every cached buffer back to the system
+  void Trim() noexcept;
+
+ protected:
+  void* DoAllocate(std::size_t bytes) override;
+  void DoDeallocate(void* ptr, std::size_t bytes) noexcept override;
+
+ private:
+  static constexpr int kClasses = 48;
+
+  std::mutex mutex_;
+  std::vector<void*> free_[kClasses];
+  std::size_t cached_bytes_;
+  std::size_t max_cached_bytes_;
+};
+
+// Bump allocator for per-request temporaries: allocation is a pointer
+// increment, deallocation does nothing and Reset() rewinds everything at
+// once, keeping the chunks for the next request. Matrices drawn from the
+// arena must be gone before Reset(). Not thread-safe: fill it from one thread.
+class S21ArenaAllocator : public S21MatrixAllocator {
+ public:
+  explicit S21ArenaAllocator(std::size_t chunk_bytes = 1u << 20);
+  ~S21ArenaAllocator() override;
+  S21ArenaAllocator(const S21ArenaAllocator&) = delete;
+  S21ArenaAllocator& operator=(const S21ArenaAllocator&) = delete;
+
+  void Reset() noexcept;
+  std::size_t Reserved() const noexcept;
+
+ protected:
+  void* DoAllocate(std::size_t bytes) override;
+  void DoDeallocate(void* ptr, std::size_t bytes) noexcept override;
+
+ private:
+  struct Chunk {
+    char* data;
+    std::size_t size;
+  };
+
+  std::vector<Chunk> chunks_;
+  std::size_t current_;
+  std::size_t offset_;
+  std::size_t chunk_bytes_;
+};
+
+// Makes matrices created on this thread draw from allocator while alive.
+// Scopes nest; the innermost one applies.
+class S21AllocatorScope {
+ public:
+  explicit S21AllocatorScope(S21MatrixAllocator& allocator) noexcept;
+  ~S21AllocatorScope();
+  S21AllocatorScope(const S21AllocatorScope&) = delete;
+  S21AllocatorScope& operator=(const S21AllocatorScope&) = delete;
+
+ private:
+  S21MatrixAllocator* previous_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_ALLOCATOR_H
@@ -0,0 +1,291 @@
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+namespace s21::async {
+
+namespace {
+
+// Executor threads still alive, across current and retired executors.
+std::mutex threads_mutex;
+std::condition_variable threads_exited;
+int live_threads = 0;
+
+// Runs queued tasks on a fixed set of detached threads, each holding a
+// reference to the executor. Retire() lets the threads drain the queue and
+// exit, and the last one frees the executor, so nothing ever joins an
+// executor thread from that same thread.
+class Executor : public std::enable_shared_from_this<Executor> {
+ public:
+  Executor() = default;
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  static std::shared_ptr<Executor> Start(int threads) {
+    auto executor = std::make_shared<Executor>();
+    for (int i = 0; i < threads; i++) {
+      {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        live_threads++;
+      }
+      std::thread([self = executor]() mutable {
+        self->Work();
+        self.reset();
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        live_threads--;
+        threads_exited.notify_all();
+      }).detach();
+    }
+    return executor;
+  }
+
+  void Post(std::shared_ptr<NodeBase> node) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(node));
+    }
+    ready_.notify_one();
+  }
+
+  // tasks still queued are run first
+  void Retire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_all();
+  }
+
+ private:
+  void Work() {
+    for (;;) {
+      std::shared_ptr<NodeBase> node;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        node = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      node->Run();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::shared_ptr<NodeBase>> queue_;
+  bool stop_ = false;
+};
+
+// Posting goes through executor under executor_mutex, so a worker never
+// takes a reference of its own that could outlive the global one.
+std::mutex executor_mutex;
+std::shared_ptr<Executor> executor;
+int executor_threads = 2;
+
+// retires the executor at exit and waits for every executor thread
+struct Shutdown {
+  ~Shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(executor_mutex);
+      if (executor != nullptr) executor->Retire();
+    }
+    std::unique_lock<std::mutex> lock(threads_mutex);
+    threads_exited.wait(lock, [] { return live_threads == 0; });
+  }
+} shutdown;
+
+}  // namespace
+
+NodeBase::~NodeBase() = default;
+
+bool NodeBase::IsFinished() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Settled();
+}
+
+bool NodeBase::IsCancelled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return state_ == State::kCancelled;
+}
+
+void NodeBase::Wait() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_.wait(lock, [this] { return Settled(); });
+}
+
+bool NodeBase::Cancel() {
+  return Finish(State::kCancelled,
+                std::make_exception_ptr(
+                    std::runtime_error("Error: the task was cancelled")),
+                true);
+}
+
+bool NodeBase::Subscribe(std::function<void()> done) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ != State::kPending && state_ != State::kRunning) return false;
+  subscribers_.push_back(std::move(done));
+  return true;
+}
+
+void NodeBase::DependOn(const std::shared_ptr<NodeBase>& input) {
+  std::shared_ptr<NodeBase> self = shared_from_this();
+  const NodeBase* from = input.get();
+  if (!input->Subscribe([self, from] { self->InputFinished(*from); })) {
+    InputFinished(*input);
+  }
+}
+
+void NodeBase::Release() {
+  if (waiting_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  if (!IsFinished()) S21Async::Submit(shared_from_this());
+}
+
+void NodeBase::Run() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::kPending) return;
+    state_ = State::kRunning;
+  }
+  try {
+    Execute();
+  } catch (...) {
+    Finish(State::kFailed, std::current_exception(), false);
+    return;
+  }
+  Finish(State::kDone, nullptr, false);
+}
+
+void NodeBase::RethrowIfFailed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (error_ != nullptr) std::rethrow_exception(error_);
+}
+
+// private methods
+bool NodeBase::Settled() const {
+  return settled_ || finisher_ == std::this_thread::get_id();
+}
+
+void NodeBase::InputFinished(const NodeBase& input) {
+  State state;
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(input.mutex_);
+    state = input.state_;
+    error = input.error_;
+  }
+  // fail or cancel at once, without waiting for the other inputs
+  if (state != State::kDone) Finish(state, error, true);
+  Release();
+}
+
+bool NodeBase::Finish(State state, std::exception_ptr error,
+                      bool only_pending) {
+  std::vector<std::function<void()>> subscribers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::kPending &&
+        (state_ != State::kRunning || only_pending)) {
+      return false;
+    }
+    state_ = state;
+    error_ = std::move(error);
+    finisher_ = std::this_thread::get_id();
+    subscribers.swap(subscribers_);
+  }
+  DropBody();
+  // dependents are queued before any waiter is let go
+  for (auto& done : subscribers) done();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    settled_ = true;
+    finisher_ = std::thread::id();
+  }
+  finished_.notify_all();
+  return true;
+}
+
+}  // namespace s21::async
+
+S21Task<S21Matrix> S21Async::SumMatrix(const S21Task<S21Matrix>& a,
+                                       const S21Task<S21Matrix>& b) {
+  return Run(
+      [](const S21Matrix& x, const S21Matrix& y) {
+        S21Matrix res(x);
+        res.SumMatrix(y);
+        return res;
+      },
+      a, b);
+}
+
+S21Task<S21Matrix> S21Async::SubMatrix(const S21Task<S21Matrix>& a,
+                                       const S21Task<S21Matrix>& b) {
+  return Run(
+      [](const S21Matrix& x, const S21Matrix& y) {
+        S21Matrix res(x);
+        res.SubMatrix(y);
+        return res;
+      },
+      a, b);
+}
+
+S21Task<S21Matrix> S21Async::MulNumber(const S21Task<S21Matrix>& a,
+                                       double num) {
+  return Run(
+      [num](const S21Matrix& x) {
+        S21Matrix res(x);
+        res *= num;
+        return res;
+      },
+      a);
+}
+
+S21Task<S21Matrix> S21Async::MulMatrix(const S21Task<S21Matrix>& a,
+                                       const S21Task<S21Matrix>& b) {
+  return Run([](const S21Matrix& x, const S21Matrix& y) { return x * y; }, a,
+             b);
+}
+
+S21Task<S21Matrix> S21Async::Transpose(const S21Task<S21Matrix>& a) {
+  return Run([](const S21Matrix& x) { return S21Matrix(x.Transpose()); }, a);
+}
+
+S21Task<double> S21Async::Determinant(const S21Task<S21Matrix>& a) {
+  return Run([](const S21Matrix& x) { return x.Determinant(); }, a);
+}
+
+S21Task<S21Matrix> S21Async::InverseMatrix(const S21Task<S21Matrix>& a) {
+  return Run([](const S21Matrix& x) { return x.InverseMatrix(); }, a);
+}
+
+void S21Async::SetThreadCount(int count) {
+  if (count < 1) {
+    throw std::out_of_range("Error: thread count must be positive");
+  }
+  std::lock_guard<std::mutex> lock(s21::async::executor_mutex);
+  if (count == s21::async::executor_threads) return;
+  s21::async::executor_threads = count;
+  // the old threads finish their queue and exit on their own, since this
+  // may run on one of them
+  if (s21::async::executor != nullptr) {
+    s21::async::executor->Retire();
+    s21::async::executor.reset();
+  }
+}
+
+int S21Async::GetThreadCount() noexcept {
+  std::lock_guard<std::mutex> lock(s21::async::executor_mutex);
+  return s21::async::executor_threads;
+}
+
+// private methods
+void S21Async::Submit(std::shared_ptr<s21::async::NodeBase> node) {
+  using namespace s21::async;
+  std::lock_guard<std::mutex> lock(executor_mutex);
+  if (executor == nullptr) executor = Executor::Start(executor_threads);
+  executor->Post(std::move(node));
+}
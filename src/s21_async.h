@@ -0,0 +1,230 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_ASYNC_H
+#define CPP1_S21_MATRIXPLUS_S21_ASYNC_H
+
+// Operations that run on a small executor of their own and hand back an
+// S21Task right away. A task can be the input of further operations. Each
+// one is a node of a dependency graph and is queued as soon as its last
+// input finishes, so chains and independent branches overlap without the
+// caller waiting in between. Every operation still splits its work over the
+// shared thread pool of S21Parallel.
+//
+// A task that throws fails, and so does everything that depends on it:
+// Get() rethrows the original exception. Cancel() stops a task that has
+// not started yet, along with its dependents. Get() on a cancelled task
+// throws std::runtime_error. A task that is already running always
+// finishes. Every task should be finished before main returns; the
+// executor threads are then waited for at exit.
+//
+// S21Task is awaitable: with C++20, co_await task resumes the coroutine on
+// the executor thread that finished the task, or right away if it is
+// already finished, and yields Get().
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21::async {
+
+// Shared state of a task, as seen by the scheduler.
+class NodeBase : public std::enable_shared_from_this<NodeBase> {
+ public:
+  explicit NodeBase(int inputs) noexcept : waiting_(inputs + 1) {}
+  virtual ~NodeBase();
+  NodeBase(const NodeBase&) = delete;
+  NodeBase& operator=(const NodeBase&) = delete;
+
+  bool IsFinished() const;
+  bool IsCancelled() const;
+  void Wait() const;
+  // false when the task had already started or finished
+  bool Cancel();
+  // calls done on the finishing thread; false, without calling it, when
+  // the task has already finished
+  bool Subscribe(std::function<void()> done);
+  // makes input one of the tasks this one waits for
+  void DependOn(const std::shared_ptr<NodeBase>& input);
+  // drops the hold taken at construction, once every input is registered
+  void Release();
+  // on an executor thread
+  void Run();
+
+ protected:
+  // a task created finished, with no inputs
+  void SetDone() noexcept {
+    state_ = State::kDone;
+    settled_ = true;
+  }
+  void RethrowIfFailed() const;
+
+ private:
+  enum class State { kPending, kRunning, kDone, kFailed, kCancelled };
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable finished_;
+  State state_ = State::kPending;
+  // set once the subscribers of a finished task have run, so that a task
+  // is only reported finished after its dependents have been queued
+  bool settled_ = false;
+  // the thread running the subscribers, which already sees the task as
+  // finished (a resumed coroutine calling Get(), for one)
+  std::thread::id finisher_;
+  std::exception_ptr error_;
+  std::vector<std::function<void()>> subscribers_;
+  // unfinished inputs, plus one until Release()
+  std::atomic<int> waiting_;
+
+  virtual void Execute() = 0;
+  // frees what the body holds once it can no longer run
+  virtual void DropBody() noexcept = 0;
+  // under mutex_
+  bool Settled() const;
+  void InputFinished(const NodeBase& input);
+  // false when the task had already finished, or had started and
+  // only_pending is set
+  bool Finish(State state, std::exception_ptr error, bool only_pending);
+};
+
+template <typename T>
+class Node final : public NodeBase {
+ public:
+  Node(int inputs, std::function<T()> body)
+      : NodeBase(inputs), body_(std::move(body)) {}
+  explicit Node(T value) : NodeBase(0), value_(std::move(value)) {
+    SetDone();
+  }
+
+  const T& Value() const {
+    Wait();
+    RethrowIfFailed();
+    return *value_;
+  }
+
+ private:
+  std::function<T()> body_;
+  std::optional<T> value_;
+
+  void Execute() override { value_.emplace(body_()); }
+  void DropBody() noexcept override { body_ = nullptr; }
+};
+
+}  // namespace s21::async
+
+class S21Async;
+
+template <typename T>
+class S21Task {
+  static_assert(!std::is_void_v<T>, "a task must produce a value");
+
+ public:
+  // constructors
+  // an empty handle, not Valid()
+  S21Task() = default;
+  // a task that is already finished with value
+  S21Task(T value)
+      : state_(std::make_shared<s21::async::Node<T>>(std::move(value))) {}
+
+  // methods
+  void Wait() const { state_->Wait(); }
+  // waits, then returns the value or rethrows what made the task fail
+  const T& Get() const { return state_->Value(); }
+  // true when it kept the task and its dependents from running
+  bool Cancel() const { return state_->Cancel(); }
+  // a task of f(Get()), queued once this one finishes
+  template <typename F>
+  auto Then(F f) const;
+
+  // accessors
+  bool Valid() const noexcept { return state_ != nullptr; }
+  // finished in any way: done, failed or cancelled
+  bool IsReady() const { return state_->IsFinished(); }
+  bool IsCancelled() const { return state_->IsCancelled(); }
+
+  // the awaitable protocol; Handle is any type with resume(), such as
+  // std::coroutine_handle<>
+  bool await_ready() const { return IsReady(); }
+  template <typename Handle>
+  bool await_suspend(Handle handle) const {
+    return state_->Subscribe([handle]() mutable { handle.resume(); });
+  }
+  const T& await_resume() const { return Get(); }
+
+ private:
+  friend class S21Async;
+
+  std::shared_ptr<s21::async::Node<T>> state_;
+
+  explicit S21Task(std::shared_ptr<s21::async::Node<T>> state)
+      : state_(std::move(state)) {}
+};
+
+class S21Async {
+ public:
+  // a task of f(inputs.Get()...), queued once every input has finished;
+  // throws std::invalid_argument for an empty input handle
+  template <typename F, typename... In>
+  static auto Run(F f, const S21Task<In>&... inputs);
+
+  // the asynchronous counterparts of the S21Matrix operations; a matrix
+  // passed in place of a task is copied, or moved, into a finished one
+  static S21Task<S21Matrix> SumMatrix(const S21Task<S21Matrix>& a,
+                                      const S21Task<S21Matrix>& b);
+  static S21Task<S21Matrix> SubMatrix(const S21Task<S21Matrix>& a,
+                                      const S21Task<S21Matrix>& b);
+  static S21Task<S21Matrix> MulNumber(const S21Task<S21Matrix>& a,
+                                      double num);
+  static S21Task<S21Matrix> MulMatrix(const S21Task<S21Matrix>& a,
+                                      const S21Task<S21Matrix>& b);
+  static S21Task<S21Matrix> Transpose(const S21Task<S21Matrix>& a);
+  static S21Task<double> Determinant(const S21Task<S21Matrix>& a);
+  static S21Task<S21Matrix> InverseMatrix(const S21Task<S21Matrix>& a);
+
+  // operations the executor runs at once; 2 by default. Tasks queued
+  // before a change still run on the old threads, which then exit on their
+  // own, so it may also be called from inside a task.
+  static void SetThreadCount(int count);
+  static int GetThreadCount() noexcept;
+
+ private:
+  friend class s21::async::NodeBase;
+
+  static void Submit(std::shared_ptr<s21::async::NodeBase> node);
+};
+
+template <typename F, typename... In>
+auto S21Async::Run(F f, const S21Task<In>&... inputs) {
+  using Result = std::decay_t<std::invoke_result_t<F&, const In&...>>;
+  if (!(inputs.Valid() && ...)) {
+    throw std::invalid_argument("Error: the task is empty");
+  }
+  auto states = std::make_tuple(inputs.state_...);
+  auto node = std::make_shared<s21::async::Node<Result>>(
+      static_cast<int>(sizeof...(In)), [f = std::move(f), states]() mutable {
+        return std::apply(
+            [&f](const auto&... state) -> Result {
+              return f(state->Value()...);
+            },
+            states);
+      });
+  (node->DependOn(inputs.state_), ...);
+  node->Release();
+  return S21Task<Result>(std::move(node));
+}
+
+template <typename T>
+template <typename F>
+auto S21Task<T>::Then(F f) const {
+  return S21Async::Run(std::move(f), *this);
+}
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_ASYNC_H
@@ -0,0 +1,557 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// elements per chunk when elementwise loops are split across threads
+constexpr std::size_t kElementGrain = 1 << 14;
+// side of the tiles the transpose walks
+constexpr int kTransposeBlock = 32;
+
+// Fraction-free Gaussian elimination on the n x n integer matrix a, which is
+// overwritten. Every division is exact, so no rounding happens; products
+// are formed in 128 bits. Returns the determinant.
+std::int64_t BareissDeterminant(std::int64_t* a, int n, int lda) {
+  auto at = [a, lda](int i, int j) -> std::int64_t& {
+    return a[static_cast<std::size_t>(i) * lda + j];
+  };
+  std::int64_t previous = 1;
+  int sign = 1;
+  for (int k = 0; k + 1 < n; k++) {
+    if (at(k, k) == 0) {
+      int row = k + 1;
+      while (row < n && at(row, k) == 0) row++;
+      if (row == n) return 0;
+      for (int j = k; j < n; j++) std::swap(at(k, j), at(row, j));
+      sign = -sign;
+    }
+    for (int i = k + 1; i < n; i++) {
+      for (int j = k + 1; j < n; j++) {
+        const __int128 value =
+            (static_cast<__int128>(at(i, j)) * at(k, k) -
+             static_cast<__int128>(at(i, k)) * at(k, j)) /
+            previous;
+        if (value > std::numeric_limits<std::int64_t>::max() ||
+            value < std::numeric_limits<std::int64_t>::min()) {
+          throw std::overflow_error("Error: integer overflow");
+        }
+        at(i, j) = static_cast<std::int64_t>(value);
+      }
+    }
+    previous = at(k, k);
+  }
+  return n == 0 ? 1 : sign * at(n - 1, n - 1);
+}
+
+// LU elimination with partial pivoting on the n x n matrix a, which is
+// overwritten. Returns the determinant.
+template <typename T>
+T LuDeterminant(T* a, int n, int lda) {
+  using Traits = S21MatrixTraits<T>;
+  auto row = [a, lda](int i) { return a + static_cast<std::size_t>(i) * lda; };
+  T det = 1;
+  for (int k = 0; k < n; k++) {
+    int pivot = k;
+    for (int i = k + 1; i < n; i++) {
+      if (Traits::Magnitude(row(i)[k]) > Traits::Magnitude(row(pivot)[k])) {
+        pivot = i;
+      }
+    }
+    if (row(pivot)[k] == T(0)) return T(0);
+    if (pivot != k) {
+      std::swap_ranges(row(k) + k, row(k) + n, row(pivot) + k);
+      det = -det;
+    }
+    det *= row(k)[k];
+    for (int i = k + 1; i < n; i++) {
+      const T factor = row(i)[k] / row(k)[k];
+      for (int j = k + 1; j < n; j++) row(i)[j] -= factor * row(k)[j];
+    }
+  }
+  return det;
+}
+
+// Block of rows of A whose products with B stay in L2 while they are used.
+constexpr int kDepthBlock = 128;
+
+// c (rows x ldb) += a (rows x k) * b (k x ldb). Rows of b and c are whole
+// cache lines with zero padding, so they are walked in vectors one line
+// wide; GCC lowers those to whatever the target has for every arithmetic
+// T. Complex elements fall back to the plain loop.
+template <typename T>
+inline __attribute__((always_inline)) void MulRowsBody(const T* a, int lda,
+                                                       const T* b, int ldb,
+                                                       T* c, int ldc, int rows,
+                                                       int k) {
+  constexpr int kLine = static_cast<int>(S21BasicMatrix<T>::kAlignment /
+                                         sizeof(T));
+  for (int p0 = 0; p0 < k; p0 += kDepthBlock) {
+    const int p1 = std::min(p0 + kDepthBlock, k);
+    for (int i = 0; i < rows; i++) {
+      T* c_row = c + static_cast<std::size_t>(i) * ldc;
+      const T* a_row = a + static_cast<std::size_t>(i) * lda;
+      for (int p = p0; p < p1; p++) {
+        const T* b_row = b + static_cast<std::size_t>(p) * ldb;
+        if constexpr (std::is_arithmetic_v<T>) {
+          typedef T Line __attribute__((vector_size(sizeof(T) * kLine)));
+          const T factor = a_row[p];
+          for (int j = 0; j < ldb; j += kLine) {
+            Line b_line, c_line;
+            std::memcpy(&b_line, b_row + j, sizeof(Line));
+            std::memcpy(&c_line, c_row + j, sizeof(Line));
+            c_line += factor * b_line;
+            std::memcpy(c_row + j, &c_line, sizeof(Line));
+          }
+        } else {
+          for (int j = 0; j < ldb; j++) c_row[j] += a_row[p] * b_row[j];
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void MulRowsDefault(const T* a, int lda, const T* b, int ldb, T* c, int ldc,
+                    int rows, int k) {
+  MulRowsBody(a, lda, b, ldb, c, ldc, rows, k);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) void MulRowsAvx2(const T* a, int lda,
+                                                     const T* b, int ldb, T* c,
+                                                     int ldc, int rows, int k) {
+  MulRowsBody(a, lda, b, ldb, c, ldc, rows, k);
+}
+
+}  // namespace
+
+// constructors
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix()
+    : rows_(0),
+      cols_(0),
+      stride_(0),
+      capacity_(0),
+      matrix_(nullptr),
+      allocator_(nullptr) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols) {
+  if (rows < 0 || cols < 0) throw std::out_of_range("Error: out of range");
+  rows_ = rows;
+  cols_ = cols;
+  Allocate();
+}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix& other)
+    : rows_(other.rows_), cols_(other.cols_) {
+  Allocate();
+  std::copy_n(other.matrix_, Elements(), matrix_);
+}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      capacity_(other.capacity_),
+      matrix_(other.matrix_),
+      allocator_(other.allocator_) {
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.stride_ = 0;
+  other.capacity_ = 0;
+  other.matrix_ = nullptr;
+}
+
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() {
+  Release();
+}
+
+// public methods
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix& other) const noexcept {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  const T* a = matrix_;
+  const T* b = other.matrix_;
+  std::atomic<bool> equal(true);
+  s21::kernels::ParallelFor(
+      Elements(), kElementGrain, Elements(),
+      [&, a, b](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          // integers compare exactly; a - b could overflow
+          const bool differs =
+              Traits::kExact
+                  ? a[i] != b[i]
+                  : Traits::Magnitude(a[i] - b[i]) > Traits::kEpsilon;
+          if (differs) {
+            equal.store(false, std::memory_order_relaxed);
+            return;
+          }
+        }
+      });
+  return equal.load();
+}
+
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix& other) {
+  checkSize(other);
+  T* a = matrix_;
+  const T* b = other.matrix_;
+  s21::kernels::ParallelFor(Elements(), kElementGrain, Elements(),
+                            [=](std::size_t begin, std::size_t end) {
+                              for (std::size_t i = begin; i < end; i++) {
+                                a[i] += b[i];
+                              }
+                            });
+}
+
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix& other) {
+  checkSize(other);
+  T* a = matrix_;
+  const T* b = other.matrix_;
+  s21::kernels::ParallelFor(Elements(), kElementGrain, Elements(),
+                            [=](std::size_t begin, std::size_t end) {
+                              for (std::size_t i = begin; i < end; i++) {
+                                a[i] -= b[i];
+                              }
+                            });
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const T num) const noexcept {
+  T* a = matrix_;
+  s21::kernels::ParallelFor(Elements(), kElementGrain, Elements(),
+                            [=](std::size_t begin, std::size_t end) {
+                              for (std::size_t i = begin; i < end; i++) {
+                                a[i] *= num;
+                              }
+                            });
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix& other) {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  S21BasicMatrix result(rows_, other.cols_);
+  const int n = other.cols_, k = cols_;
+  const bool avx2 =
+      s21::kernels::ActiveSimdLevel() >= s21::kernels::SimdLevel::kAvx2;
+  s21::kernels::ParallelFor(
+      rows_, 16, 2 * static_cast<std::size_t>(rows_) * n * k,
+      [&, k, avx2](std::size_t begin, std::size_t end) {
+        const int first = static_cast<int>(begin);
+        const int count = static_cast<int>(end) - first;
+        auto rows = avx2 ? MulRowsAvx2<T> : MulRowsDefault<T>;
+        rows(RowData(first), stride_, other.matrix_, other.stride_,
+             result.RowData(first), result.stride_, count, k);
+      });
+  *this = std::move(result);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() const {
+  S21BasicMatrix result(cols_, rows_);
+  for (int ib = 0; ib < rows_; ib += kTransposeBlock) {
+    const int ie = std::min(ib + kTransposeBlock, rows_);
+    for (int jb = 0; jb < cols_; jb += kTransposeBlock) {
+      const int je = std::min(jb + kTransposeBlock, cols_);
+      for (int i = ib; i < ie; i++) {
+        for (int j = jb; j < je; j++) result.RowData(j)[i] = RowData(i)[j];
+      }
+    }
+  }
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() const {
+  checkSquare();
+  S21BasicMatrix result(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      const T det = GetMinor(i, j).Determinant();
+      result(i, j) = (i + j) % 2 == 0 ? det : -det;
+    }
+  }
+  return result;
+}
+
+template <typename T>
+T S21BasicMatrix<T>::Determinant() const {
+  checkSquare();
+  S21BasicMatrix work(*this);
+  if constexpr (Traits::kExact) {
+    return BareissDeterminant(work.matrix_, rows_, work.stride_);
+  } else {
+    return LuDeterminant(work.matrix_, rows_, work.stride_);
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() const {
+  checkSquare();
+  const int n = rows_;
+  if constexpr (Traits::kExact) {
+    const T det = Determinant();
+    if (det == 0) throw std::out_of_range("Error: determinant = 0");
+    if (det != 1 && det != -1) {
+      throw std::invalid_argument(
+          "Error: the inverse is not an integer matrix");
+    }
+    // 1 / det == det for a unimodular matrix
+    S21BasicMatrix result = CalcComplements().Transpose();
+    result.MulNumber(det);
+    return result;
+  } else {
+    // Gauss-Jordan with partial pivoting on a copy and the identity
+    using Real = typename Traits::Real;
+    S21BasicMatrix work(*this), result(n, n);
+    Real largest = 0;
+    for (int i = 0; i < n; i++) {
+      result(i, i) = T(1);
+      for (int j = 0; j < n; j++) {
+        largest = std::max(largest, Traits::Magnitude(work(i, j)));
+      }
+    }
+    const Real tolerance = n * std::numeric_limits<Real>::epsilon() * largest;
+    for (int k = 0; k < n; k++) {
+      int pivot = k;
+      for (int i = k + 1; i < n; i++) {
+        if (Traits::Magnitude(work(i, k)) > Traits::Magnitude(work(pivot, k))) {
+          pivot = i;
+        }
+      }
+      if (!(Traits::Magnitude(work(pivot, k)) > tolerance)) {
+        throw std::out_of_range("Error: determinant = 0");
+      }
+      if (pivot != k) {
+        std::swap_ranges(work.RowData(k), work.RowData(k) + n,
+                         work.RowData(pivot));
+        std::swap_ranges(result.RowData(k), result.RowData(k) + n,
+                         result.RowData(pivot));
+      }
+      const T scale = T(1) / work(k, k);
+      for (int j = 0; j < n; j++) {
+        work.RowData(k)[j] *= scale;
+        result.RowData(k)[j] *= scale;
+      }
+      for (int i = 0; i < n; i++) {
+        const T factor = work(i, k);
+        if (i == k || factor == T(0)) continue;
+        for (int j = 0; j < n; j++) {
+          work.RowData(i)[j] -= factor * work.RowData(k)[j];
+          result.RowData(i)[j] -= factor * result.RowData(k)[j];
+        }
+      }
+    }
+    return result;
+  }
+}
+
+// operators
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(const S21BasicMatrix& other) {
+  if (this != &other) {
+    if (other.Elements() > capacity_) {
+      S21BasicMatrix copy(other);
+      return *this = std::move(copy);
+    }
+    // the current buffer is large enough: keep it
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    std::copy_n(other.matrix_, Elements(), matrix_);
+  }
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(
+    S21BasicMatrix&& other) noexcept {
+  if (this != &other) {
+    Release();
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    capacity_ = other.capacity_;
+    matrix_ = other.matrix_;
+    allocator_ = other.allocator_;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.capacity_ = 0;
+    other.matrix_ = nullptr;
+  }
+  return *this;
+}
+
+template <typename T>
+T& S21BasicMatrix<T>::operator()(int row, int col) const {
+  if (cols_ <= col || rows_ <= row || row < 0 || col < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  return matrix_[static_cast<std::size_t>(row) * stride_ + col];
+}
+
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const T other) {
+  MulNumber(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const S21BasicMatrix& other) {
+  MulMatrix(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(const S21BasicMatrix& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(const S21BasicMatrix& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix& other) const noexcept {
+  return EqMatrix(other);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator+(
+    const S21BasicMatrix& other) const {
+  S21BasicMatrix result(*this);
+  result.SumMatrix(other);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator-(
+    const S21BasicMatrix& other) const {
+  S21BasicMatrix result(*this);
+  result.SubMatrix(other);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(
+    const S21BasicMatrix& other) const {
+  S21BasicMatrix result(*this);
+  result.MulMatrix(other);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(const T num) const {
+  S21BasicMatrix result(*this);
+  result.MulNumber(num);
+  return result;
+}
+
+// mutators
+template <typename T>
+void S21BasicMatrix<T>::SetRows(const int value) {
+  if (value < 0) throw std::out_of_range("Error: invalid size of matrix");
+  if (value == rows_) return;
+  S21BasicMatrix resized(value, cols_);
+  const int kept = std::min(value, rows_);
+  std::copy_n(matrix_, static_cast<std::size_t>(kept) * stride_,
+              resized.matrix_);
+  *this = std::move(resized);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::SetCols(const int value) {
+  if (value < 0) throw std::out_of_range("Error: invalid size of matrix");
+  if (value == cols_) return;
+  S21BasicMatrix resized(rows_, value);
+  const int kept = std::min(value, cols_);
+  for (int i = 0; i < rows_; i++) {
+    std::copy_n(RowData(i), kept, resized.RowData(i));
+  }
+  *this = std::move(resized);
+}
+
+// private methods
+template <typename T>
+void S21BasicMatrix<T>::Allocate() {
+  static_assert(std::is_trivially_destructible_v<T>,
+                "elements are released without running destructors");
+  stride_ = PaddedStride(cols_);
+  capacity_ = Elements();
+  matrix_ = nullptr;
+  allocator_ = &S21CurrentAllocator();
+  if (capacity_ > 0) {
+    matrix_ = static_cast<T*>(allocator_->Allocate(sizeof(T) * capacity_));
+    std::uninitialized_fill_n(matrix_, capacity_, T(0));
+  }
+}
+
+template <typename T>
+void S21BasicMatrix<T>::Release() noexcept {
+  if (matrix_ != nullptr) {
+    allocator_->Deallocate(matrix_, sizeof(T) * capacity_);
+    matrix_ = nullptr;
+  }
+  capacity_ = 0;
+}
+
+template <typename T>
+std::size_t S21BasicMatrix<T>::Elements() const noexcept {
+  return static_cast<std::size_t>(rows_) * stride_;
+}
+
+template <typename T>
+int S21BasicMatrix<T>::PaddedStride(int cols) noexcept {
+  const int per_line = static_cast<int>(kAlignment / sizeof(T));
+  return (cols + per_line - 1) / per_line * per_line;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::GetMinor(int row, int col) const {
+  S21BasicMatrix minor(rows_ - 1, cols_ - 1);
+  for (int i = 0, src = 0; i < minor.rows_; i++, src++) {
+    if (src == row) src++;
+    const T* from = RowData(src);
+    T* to = minor.RowData(i);
+    std::copy_n(from, col, to);
+    std::copy_n(from + col + 1, cols_ - col - 1, to + col);
+  }
+  return minor;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::checkSquare() const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+}
+
+template <typename T>
+void S21BasicMatrix<T>::checkSize(const S21BasicMatrix& other) const {
+  if (other.rows_ != rows_ || other.cols_ != cols_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+}
+
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<std::int64_t>;
+template class S21BasicMatrix<std::complex<double>>;
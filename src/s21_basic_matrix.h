@@ -0,0 +1,112 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_BASIC_MATRIX_H
+#define CPP1_S21_MATRIXPLUS_S21_BASIC_MATRIX_H
+
+// Generic S21BasicMatrix<T> for the element types other than double:
+// float, std::int64_t and std::complex<double>, instantiated in
+// s21_basic_matrix.cc. The storage layout (rows padded to kAlignment bytes,
+// buffers from the current S21MatrixAllocator) and the methods match
+// S21Matrix, but every operator computes its result right away instead of
+// building an expression. Equality uses S21MatrixTraits<T>::kEpsilon;
+// integer determinants come from fraction-free Bareiss elimination and are
+// exact. Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T>
+class S21BasicMatrix {
+ public:
+  using Traits = S21MatrixTraits<T>;
+
+  // constructors
+  S21BasicMatrix();
+  ~S21BasicMatrix();
+  explicit S21BasicMatrix(int rows, int cols);
+  S21BasicMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix(S21BasicMatrix&& other) noexcept;
+  // converts every element, e.g. S21BasicMatrix<float>(an_S21Matrix)
+  template <typename U>
+  explicit S21BasicMatrix(const S21BasicMatrix<U>& other);
+
+  // methods
+  bool EqMatrix(const S21BasicMatrix& other) const noexcept;
+  void SumMatrix(const S21BasicMatrix& other);
+  void SubMatrix(const S21BasicMatrix& other);
+  void MulNumber(const T num) const noexcept;
+  void MulMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix Transpose() const;
+  S21BasicMatrix CalcComplements() const;
+  // throws std::overflow_error when an integer determinant does not fit
+  T Determinant() const;
+  // an integer matrix only has an integer inverse when its determinant is
+  // 1 or -1; any other non-zero determinant throws std::invalid_argument
+  S21BasicMatrix InverseMatrix() const;
+
+  // operators
+  S21BasicMatrix& operator=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(S21BasicMatrix&& other) noexcept;
+  T& operator()(int row, int col) const;
+  S21BasicMatrix& operator*=(const T other);
+  S21BasicMatrix& operator*=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator+=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator-=(const S21BasicMatrix& other);
+  bool operator==(const S21BasicMatrix& other) const noexcept;
+  S21BasicMatrix operator+(const S21BasicMatrix& other) const;
+  S21BasicMatrix operator-(const S21BasicMatrix& other) const;
+  S21BasicMatrix operator*(const S21BasicMatrix& other) const;
+  S21BasicMatrix operator*(const T num) const;
+  friend S21BasicMatrix operator*(const T num, const S21BasicMatrix& m) {
+    return m * num;
+  }
+
+  // accesors
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  int Stride() const noexcept { return stride_; }
+  T* Data() noexcept { return matrix_; }
+  const T* Data() const noexcept { return matrix_; }
+  T* RowData(int row) noexcept {
+    return matrix_ + static_cast<std::size_t>(row) * stride_;
+  }
+  const T* RowData(int row) const noexcept {
+    return matrix_ + static_cast<std::size_t>(row) * stride_;
+  }
+  // mutators
+  void SetRows(int value);
+  void SetCols(int value);
+
+  static constexpr std::size_t kAlignment = 64;
+
+ private:
+  int rows_, cols_;
+  int stride_;
+  std::size_t capacity_;
+  T* matrix_;
+  S21MatrixAllocator* allocator_;
+
+  void Allocate();
+  void Release() noexcept;
+  std::size_t Elements() const noexcept;
+  static int PaddedStride(int cols) noexcept;
+  S21BasicMatrix GetMinor(int row, int col) const;
+  void checkSquare() const;
+  void checkSize(const S21BasicMatrix& other) const;
+};
+
+extern template class S21BasicMatrix<float>;
+extern template class S21BasicMatrix<std::int64_t>;
+extern template class S21BasicMatrix<std::complex<double>>;
+
+template <typename T>
+template <typename U>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix<U>& other)
+    : S21BasicMatrix(other.GetRows(), other.GetCols()) {
+  for (int i = 0; i < rows_; i++) {
+    const U* from = other.RowData(i);
+    T* to = RowData(i);
+    for (int j = 0; j < cols_; j++) to[j] = static_cast<T>(from[j]);
+  }
+}
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_BASIC_MATRIX_H
@@ -0,0 +1,94 @@
+#include <cmath>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+// constructors
+S21CholeskyFactorization::S21CholeskyFactorization(const S21Matrix& matrix)
+    : l_(matrix) {
+  Factor();
+}
+
+S21CholeskyFactorization::S21CholeskyFactorization(S21Matrix&& matrix)
+    : l_(std::move(matrix)) {
+  Factor();
+}
+
+// methods
+S21Matrix S21CholeskyFactorization::Solve(const S21Matrix& b) const {
+  S21Matrix x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+std::vector<double> S21CholeskyFactorization::Solve(
+    const std::vector<double>& b) const {
+  std::vector<double> x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+void S21CholeskyFactorization::SolveInPlace(S21Matrix& b) const {
+  checkRows(b.GetRows());
+  SolveInPlace(b.Data(), b.GetCols(), b.Stride());
+}
+
+void S21CholeskyFactorization::SolveInPlace(std::vector<double>& b) const {
+  checkRows(static_cast<int>(b.size()));
+  SolveInPlace(b.data(), 1, 1);
+}
+
+void S21CholeskyFactorization::SolveInPlace(double* b, int cols,
+                                            int ld) const {
+  using s21::kernels::Strided;
+  if (cols < 0 || ld < cols) throw std::out_of_range("Error: out of range");
+  checkSolvable();
+  // L y = b, then L^T x = y with L^T read as L with the strides swapped
+  const int n = GetSize();
+  s21::kernels::TriangularSolve(Strided{l_.Data(), l_.Stride(), 1}, n, true,
+                                false, b, cols, ld);
+  s21::kernels::TriangularSolve(Strided{l_.Data(), 1, l_.Stride()}, n, false,
+                                false, b, cols, ld);
+}
+
+double S21CholeskyFactorization::Determinant() const noexcept {
+  if (!positive_definite_) return 0;
+  double det = 1;
+  for (int i = 0; i < GetSize(); i++) det *= l_(i, i) * l_(i, i);
+  return det;
+}
+
+double S21CholeskyFactorization::LogDeterminant() const noexcept {
+  if (!positive_definite_) return -HUGE_VAL;
+  double res = 0;
+  for (int i = 0; i < GetSize(); i++) res += 2 * std::log(l_(i, i));
+  return res;
+}
+
+S21Matrix S21CholeskyFactorization::InverseMatrix() const {
+  checkSolvable();
+  const int n = GetSize();
+  S21Matrix inverse(n, n);
+  for (int i = 0; i < n; i++) inverse(i, i) = 1;
+  SolveInPlace(inverse);
+  return inverse;
+}
+
+// private methods
+void S21CholeskyFactorization::Factor() {
+  if (l_.GetRows() != l_.GetCols()) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+  positive_definite_ =
+      s21::kernels::CholeskyFactor(l_.Data(), GetSize(), l_.Stride());
+}
+
+void S21CholeskyFactorization::checkSolvable() const {
+  if (!positive_definite_) {
+    throw std::out_of_range("Error: the matrix is not positive definite");
+  }
+}
+
+void S21CholeskyFactorization::checkRows(int rows) const {
+  if (rows != GetSize()) throw std::out_of_range("Error: Wrong matrix size");
+}
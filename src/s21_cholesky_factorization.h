@@ -0,0 +1,51 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_CHOLESKY_FACTORIZATION_H
+#define CPP1_S21_MATRIXPLUS_S21_CHOLESKY_FACTORIZATION_H
+
+// Cholesky factorization A = L L^T of a symmetric positive definite
+// matrix. It needs no pivoting and half the operations of LU (n^3 / 3).
+// Only the lower triangle of A is read, and symmetry is assumed, not
+// checked. A matrix that turns out not to be positive definite leaves the
+// object in a state where IsPositiveDefinite() is false, and solving or
+// inverting then throws std::out_of_range.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <vector>
+
+class S21CholeskyFactorization {
+ public:
+  // constructors; throw std::invalid_argument for a non-square matrix
+  explicit S21CholeskyFactorization(const S21Matrix& matrix);
+  // factors in the buffer of matrix
+  explicit S21CholeskyFactorization(S21Matrix&& matrix);
+
+  // methods
+  // the solution X of A X = b for n x k b
+  S21Matrix Solve(const S21Matrix& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  // overwrite b with the solution, without allocating
+  void SolveInPlace(S21Matrix& b) const;
+  void SolveInPlace(std::vector<double>& b) const;
+  // caller-provided storage: n rows of cols elements, ld apart
+  void SolveInPlace(double* b, int cols, int ld) const;
+  // 0 when the matrix is not positive definite
+  double Determinant() const noexcept;
+  // log det; -HUGE_VAL when the matrix is not positive definite
+  double LogDeterminant() const noexcept;
+  S21Matrix InverseMatrix() const;
+
+  // accessors
+  int GetSize() const noexcept { return l_.GetRows(); }
+  bool IsPositiveDefinite() const noexcept { return positive_definite_; }
+  // L, zero above the diagonal
+  const S21Matrix& Lower() const noexcept { return l_; }
+
+ private:
+  S21Matrix l_;
+  bool positive_definite_;
+
+  void Factor();
+  void checkSolvable() const;
+  void checkRows(int rows) const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_CHOLESKY_FACTORIZATION_H
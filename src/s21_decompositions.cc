@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+
+#include "s21_kernels.h"
+
+namespace s21::kernels {
+
+namespace {
+
+// Cholesky
+
+// row i of the panel columns [k0, k1): a_ij = (a_ij - sum_p a_ip a_jp) /
+// a_jj, the sum running over the panel columns left of j
+void SolvePanelRow(double* a, int lda, int i, int k0, int k1) {
+  double* row = a + static_cast<std::size_t>(i) * lda;
+  for (int j = k0; j < k1; j++) {
+    const double* pivot_row = a + static_cast<std::size_t>(j) * lda;
+    double sum = row[j];
+    for (int p = k0; p < j; p++) sum -= row[p] * pivot_row[p];
+    row[j] = sum / pivot_row[j];
+  }
+}
+
+// QR
+
+// Householder reflectors for the columns [k0, k1), each also applied to
+// the panel columns right of it
+void QrPanel(double* a, int m, int lda, int k0, int k1, double* tau) {
+  auto at = [=](int i, int j) -> double& {
+    return a[static_cast<std::size_t>(i) * lda + j];
+  };
+  double w[kQrBlock];
+  for (int j = k0; j < k1; j++) {
+    const double alpha = at(j, j);
+    double sigma = 0;
+    for (int i = j + 1; i < m; i++) sigma += at(i, j) * at(i, j);
+    if (sigma == 0) {
+      tau[j] = 0;
+      continue;
+    }
+    const double norm = std::sqrt(alpha * alpha + sigma);
+    const double beta = alpha <= 0 ? norm : -norm;
+    const double scale = 1 / (alpha - beta);
+    for (int i = j + 1; i < m; i++) at(i, j) *= scale;
+    tau[j] = (beta - alpha) / beta;
+    at(j, j) = beta;
+    // w = v^T A(j:m, j+1:k1), then A -= tau v w
+    const int cols = k1 - j - 1;
+    if (cols == 0) continue;
+    for (int c = 0; c < cols; c++) w[c] = at(j, j + 1 + c);
+    for (int i = j + 1; i < m; i++) {
+      const double v = at(i, j);
+      const double* row = &at(i, j + 1);
+      for (int c = 0; c < cols; c++) w[c] += v * row[c];
+    }
+    for (int c = 0; c < cols; c++) {
+      w[c] *= tau[j];
+      at(j, j + 1 + c) -= w[c];
+    }
+    for (int i = j + 1; i < m; i++) {
+      const double v = at(i, j);
+      double* row = &at(i, j + 1);
+      for (int c = 0; c < cols; c++) row[c] -= v * w[c];
+    }
+  }
+}
+
+// The panel [k0, k0 + width) as I - Y T Y^T: y gets the m - k0 rows of
+// its reflectors (unit diagonal, zeros above it), t the width x width
+// upper triangular T, built column by column as in LAPACK's dlarft.
+void BlockReflector(const double* qr, int m, int ldqr, const double* tau,
+                    int k0, int width, double* y, double* t) {
+  const int rows = m - k0;
+  for (int r = 0; r < rows; r++) {
+    const double* from = qr + static_cast<std::size_t>(k0 + r) * ldqr + k0;
+    double* to = y + static_cast<std::size_t>(r) * width;
+    for (int p = 0; p < width; p++) {
+      to[p] = r > p ? from[p] : (r == p ? 1.0 : 0.0);
+    }
+  }
+  double z[kQrBlock];
+  for (int j = 0; j < width; j++) {
+    // z = Y(:, 0:j)^T y_j, where y_j starts at row j
+    std::fill(z, z + j, 0.0);
+    for (int r = j; r < rows; r++) {
+      const double* row = y + static_cast<std::size_t>(r) * width;
+      for (int p = 0; p < j; p++) z[p] += row[p] * row[j];
+    }
+    const double tau_j = tau[k0 + j];
+    for (int p = 0; p < j; p++) {
+      double sum = 0;
+      for (int q = p; q < j; q++) sum += t[p * width + q] * z[q];
+      t[p * width + j] = -tau_j * sum;
+    }
+    t[j * width + j] = tau_j;
+    for (int p = j + 1; p < width; p++) t[p * width + j] = 0;
+  }
+}
+
+// c = (I - Y T^T Y^T) c (transpose) or (I - Y T Y^T) c for the
+// rows x cols block c; the two products with Y go through Gemm
+void ApplyBlockReflector(const double* y, int rows, int width,
+                         const double* t, bool transpose, double* c,
+                         int cols, int ldc) {
+  double* w =
+      Scratch<double>(static_cast<std::size_t>(width) * cols, kScratchRows);
+  Gemm(width, cols, rows, Strided{y, 1, width}, Strided{c, ldc, 1}, w, cols,
+       false);
+  // w = -op(T) w in place: op(T) = T^T is lower triangular, so its rows
+  // are formed bottom up, T's own rows top down
+  auto w_row = [=](int r) { return w + static_cast<std::size_t>(r) * cols; };
+  for (int s = 0; s < width; s++) {
+    const int r = transpose ? width - 1 - s : s;
+    double* row = w_row(r);
+    const double diagonal = -t[r * width + r];
+    for (int j = 0; j < cols; j++) row[j] *= diagonal;
+    const int p0 = transpose ? 0 : r + 1, p1 = transpose ? r : width;
+    for (int p = p0; p < p1; p++) {
+      const double f = transpose ? t[p * width + r] : t[r * width + p];
+      const double* from = w_row(p);
+      for (int j = 0; j < cols; j++) row[j] -= f * from[j];
+    }
+  }
+  Gemm(rows, cols, width, y, width, w, cols, c, ldc, true);
+}
+
+}  // namespace
+
+bool CholeskyFactor(double* a, int n, int lda) noexcept {
+  const std::size_t order = n > 0 ? n : 0;
+  CountFlops(S21Instrumentation::kCholesky, order * order * order / 3);
+  auto at = [=](int i, int j) -> double& {
+    return a[static_cast<std::size_t>(i) * lda + j];
+  };
+  const int nb = kCholeskyBlock;
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int k1 = std::min(n, k0 + nb);
+    // the diagonal block; earlier panels were already subtracted from it
+    for (int j = k0; j < k1; j++) {
+      double d = at(j, j);
+      for (int p = k0; p < j; p++) d -= at(j, p) * at(j, p);
+      if (!(d > 0)) return false;
+      at(j, j) = std::sqrt(d);
+      for (int i = j + 1; i < k1; i++) {
+        double sum = at(i, j);
+        for (int p = k0; p < j; p++) sum -= at(i, p) * at(j, p);
+        at(i, j) = sum / at(j, j);
+      }
+    }
+    if (k1 == n) break;
+    // L21 = A21 L11^-T, row by row
+    const std::size_t rest = n - k1;
+    const std::size_t width = k1 - k0;
+    ParallelFor(rest, 16, rest * width * width,
+                [=](std::size_t begin, std::size_t end) {
+                  for (std::size_t r = begin; r < end; r++) {
+                    SolvePanelRow(a, lda, static_cast<int>(k1 + r), k0, k1);
+                  }
+                });
+    // A22 -= L21 L21^T on and below the diagonal, a block of rows at a
+    // time; Gemm only adds, so it multiplies a negated copy of L21
+    double* negated = Scratch<double>(rest * width, kScratchPanel);
+    for (std::size_t r = 0; r < rest; r++) {
+      for (std::size_t p = 0; p < width; p++) {
+        negated[r * width + p] = -at(static_cast<int>(k1 + r), k0 + p);
+      }
+    }
+    const Strided l21_t{&at(k1, k0), 1, lda};
+    for (int r0 = k1; r0 < n; r0 += nb) {
+      const int r1 = std::min(n, r0 + nb);
+      Gemm(r1 - r0, r1 - k1, static_cast<int>(width),
+           Strided{negated + (r0 - k1) * width,
+                   static_cast<std::ptrdiff_t>(width), 1},
+           l21_t, &at(r0, k1), lda, true);
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    std::fill(&at(i, 0) + i + 1, &at(i, 0) + n, 0.0);
+  }
+  return true;
+}
+
+void QrFactor(double* a, int m, int n, int lda, double* tau) noexcept {
+  const double rows = m, cols = n;
+  CountFlops(S21Instrumentation::kQr,
+             static_cast<std::size_t>(2 * rows * cols * cols -
+                                      2 * cols * cols * cols / 3));
+  const int nb = kQrBlock;
+  double t[kQrBlock * kQrBlock];
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int k1 = std::min(n, k0 + nb);
+    QrPanel(a, m, lda, k0, k1, tau);
+    if (k1 == n) break;
+    double* y = Scratch<double>(static_cast<std::size_t>(m - k0) * (k1 - k0),
+                                kScratchPanel);
+    BlockReflector(a, m, lda, tau, k0, k1 - k0, y, t);
+    ApplyBlockReflector(y, m - k0, k1 - k0, t, true,
+                        a + static_cast<std::size_t>(k0) * lda + k1, n - k1,
+                        lda);
+  }
+}
+
+void QrApply(const double* qr, int m, int n, int ldqr, const double* tau,
+             bool transpose, double* b, int k, int ldb) noexcept {
+  if (k <= 0) return;
+  CountFlops(S21Instrumentation::kQr,
+             static_cast<std::size_t>(4.0 * m * n * k - 2.0 * n * n * k));
+  const int nb = kQrBlock;
+  const int panels = (n + nb - 1) / nb;
+  double t[kQrBlock * kQrBlock];
+  // Q^T = H_{n-1} ... H_0 applies the first panel first, Q the last
+  for (int s = 0; s < panels; s++) {
+    const int k0 = (transpose ? s : panels - 1 - s) * nb;
+    const int width = std::min(nb, n - k0);
+    double* y = Scratch<double>(static_cast<std::size_t>(m - k0) * width,
+                                kScratchPanel);
+    BlockReflector(qr, m, ldqr, tau, k0, width, y, t);
+    ApplyBlockReflector(y, m - k0, width, t, transpose,
+                        b + static_cast<std::size_t>(k0) * ldb, k, ldb);
+  }
+}
+
+}  // namespace s21::kernels
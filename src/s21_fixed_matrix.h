@@ -0,0 +1,301 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_FIXED_MATRIX_H
+#define CPP1_S21_MATRIXPLUS_S21_FIXED_MATRIX_H
+
+// Matrix whose shape is part of its type, for the 2x2, 3x3 and 4x4
+// transforms that dominate geometry code. Elements live inside the object,
+// so nothing is allocated, everything is constexpr, and adding or
+// multiplying matrices of the wrong shape does not compile. Determinant,
+// CalcComplements and InverseMatrix use fully unrolled closed forms and
+// exist for square matrices up to 4x4; larger ones belong in S21Matrix.
+// T defaults to double; any type with the arithmetic operators works, which
+// is how S21MatrixBatch runs the same formulas over vectors of matrices.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <limits>
+#include <type_traits>
+
+template <int R, int C, typename T = double>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "S21FixedMatrix needs at least one element");
+
+ public:
+  // constructors
+  constexpr S21FixedMatrix() : matrix_{} {}
+  // all R * C elements, row by row: S21FixedMatrix<2, 2> m(1, 2, 3, 4)
+  template <typename... Values,
+            typename = std::enable_if_t<
+                sizeof...(Values) == R * C &&
+                (std::is_arithmetic_v<Values> && ...)>>
+  constexpr S21FixedMatrix(Values... values) : matrix_{} {
+    const T list[] = {static_cast<T>(values)...};
+    for (int i = 0; i < R * C; i++) matrix_[i / C][i % C] = list[i];
+  }
+  // throws std::out_of_range when m is not R x C
+  explicit S21FixedMatrix(const S21Matrix& m) : matrix_{} {
+    if (m.GetRows() != R || m.GetCols() != C) {
+      throw std::out_of_range("Error: Wrong matrix size");
+    }
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix_[i][j] = m.RowData(i)[j];
+    }
+  }
+  explicit operator S21Matrix() const {
+    S21Matrix m(R, C);
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) m.RowData(i)[j] = matrix_[i][j];
+    }
+    return m;
+  }
+
+  static constexpr S21FixedMatrix Identity() {
+    static_assert(R == C, "the identity matrix is square");
+    S21FixedMatrix m;
+    for (int i = 0; i < R; i++) m.matrix_[i][i] = T(1);
+    return m;
+  }
+
+  // methods
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const noexcept {
+    const T eps = S21MatrixTraits<T>::kEpsilon;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        const T diff = matrix_[i][j] - other.matrix_[i][j];
+        if (diff > eps || -diff > eps) return false;
+      }
+    }
+    return true;
+  }
+  constexpr void SumMatrix(const S21FixedMatrix& other) noexcept {
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix_[i][j] += other.matrix_[i][j];
+    }
+  }
+  constexpr void SubMatrix(const S21FixedMatrix& other) noexcept {
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix_[i][j] -= other.matrix_[i][j];
+    }
+  }
+  constexpr void MulNumber(const T num) noexcept {
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix_[i][j] *= num;
+    }
+  }
+  // only square right operands keep the shape
+  constexpr void MulMatrix(const S21FixedMatrix<C, C, T>& other) noexcept {
+    *this = *this * other;
+  }
+  constexpr S21FixedMatrix<C, R, T> Transpose() const noexcept {
+    S21FixedMatrix<C, R, T> result;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) result(j, i) = matrix_[i][j];
+    }
+    return result;
+  }
+  constexpr T Determinant() const noexcept {
+    static_assert(R == C, "the matrix must be square");
+    static_assert(R <= 4, "closed forms stop at 4x4, use S21Matrix");
+    const auto& a = matrix_;
+    if constexpr (R == 1) {
+      return a[0][0];
+    } else if constexpr (R == 2) {
+      return a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    } else if constexpr (R == 3) {
+      return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+             a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+             a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    } else {
+      const Pairs p = PairDeterminants();
+      return p.s[0] * p.c[5] - p.s[1] * p.c[4] + p.s[2] * p.c[3] +
+             p.s[3] * p.c[2] - p.s[4] * p.c[1] + p.s[5] * p.c[0];
+    }
+  }
+  constexpr S21FixedMatrix CalcComplements() const noexcept {
+    static_assert(R == C, "the matrix must be square");
+    static_assert(R <= 4, "closed forms stop at 4x4, use S21Matrix");
+    return Adjugate().Transpose();
+  }
+  // throws std::out_of_range when the determinant vanishes relative to the
+  // size of the elements
+  constexpr S21FixedMatrix InverseMatrix() const {
+    static_assert(R == C, "the matrix must be square");
+    static_assert(R <= 4, "closed forms stop at 4x4, use S21Matrix");
+    T largest = 0;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        const T v = matrix_[i][j] < 0 ? -matrix_[i][j] : matrix_[i][j];
+        if (v > largest) largest = v;
+      }
+    }
+    T scale = 1;
+    for (int i = 0; i < R; i++) scale *= largest;
+    const T det = Determinant();
+    const T tolerance = R * std::numeric_limits<T>::epsilon() * scale;
+    if (!(det > tolerance || -det > tolerance)) {
+      throw std::out_of_range("Error: determinant = 0");
+    }
+    S21FixedMatrix result = Adjugate();
+    result.MulNumber(1 / det);
+    return result;
+  }
+
+  // operators
+  constexpr T& operator()(int row, int col) {
+    checkIndex(row, col);
+    return matrix_[row][col];
+  }
+  constexpr const T& operator()(int row, int col) const {
+    checkIndex(row, col);
+    return matrix_[row][col];
+  }
+  // checked when compiling rather than when running
+  template <int Row, int Col>
+  constexpr T& At() noexcept {
+    static_assert(Row >= 0 && Row < R && Col >= 0 && Col < C,
+                  "index out of range");
+    return matrix_[Row][Col];
+  }
+  template <int Row, int Col>
+  constexpr const T& At() const noexcept {
+    static_assert(Row >= 0 && Row < R && Col >= 0 && Col < C,
+                  "index out of range");
+    return matrix_[Row][Col];
+  }
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) noexcept {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) noexcept {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const T num) noexcept {
+    MulNumber(num);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(
+      const S21FixedMatrix<C, C, T>& other) noexcept {
+    MulMatrix(other);
+    return *this;
+  }
+  constexpr bool operator==(const S21FixedMatrix& other) const noexcept {
+    return EqMatrix(other);
+  }
+  constexpr S21FixedMatrix operator+(const S21FixedMatrix& other) const {
+    S21FixedMatrix result(*this);
+    result.SumMatrix(other);
+    return result;
+  }
+  constexpr S21FixedMatrix operator-(const S21FixedMatrix& other) const {
+    S21FixedMatrix result(*this);
+    result.SubMatrix(other);
+    return result;
+  }
+  constexpr S21FixedMatrix operator*(const T num) const noexcept {
+    S21FixedMatrix result(*this);
+    result.MulNumber(num);
+    return result;
+  }
+  friend constexpr S21FixedMatrix operator*(const T num,
+                                            const S21FixedMatrix& m) noexcept {
+    return m * num;
+  }
+  template <int K>
+  constexpr S21FixedMatrix<R, K, T> operator*(
+      const S21FixedMatrix<C, K, T>& other) const noexcept {
+    S21FixedMatrix<R, K, T> result;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < K; j++) {
+        T sum{};
+        for (int p = 0; p < C; p++) sum += matrix_[i][p] * other(p, j);
+        result(i, j) = sum;
+      }
+    }
+    return result;
+  }
+
+  // accessors
+  static constexpr int GetRows() noexcept { return R; }
+  static constexpr int GetCols() noexcept { return C; }
+
+ private:
+  T matrix_[R][C];
+
+  // the twelve 2x2 determinants the 4x4 closed forms are built from: s from
+  // the top two rows, c from the bottom two
+  struct Pairs {
+    T s[6];
+    T c[6];
+  };
+
+  constexpr Pairs PairDeterminants() const noexcept {
+    const auto& a = matrix_;
+    Pairs p{};
+    p.s[0] = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+    p.s[1] = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+    p.s[2] = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+    p.s[3] = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+    p.s[4] = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+    p.s[5] = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+    p.c[5] = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+    p.c[4] = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+    p.c[3] = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+    p.c[2] = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+    p.c[1] = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+    p.c[0] = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+    return p;
+  }
+
+  // transposed matrix of complements, i.e. det * inverse
+  constexpr S21FixedMatrix Adjugate() const noexcept {
+    const auto& a = matrix_;
+    S21FixedMatrix r;
+    auto& b = r.matrix_;
+    if constexpr (R == 1) {
+      b[0][0] = T{} + 1;  // a plain 1 does not convert to vector types
+    } else if constexpr (R == 2) {
+      b[0][0] = a[1][1];
+      b[0][1] = -a[0][1];
+      b[1][0] = -a[1][0];
+      b[1][1] = a[0][0];
+    } else if constexpr (R == 3) {
+      b[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+      b[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+      b[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+      b[1][0] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+      b[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+      b[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+      b[2][0] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+      b[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+      b[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    } else {
+      const Pairs p = PairDeterminants();
+      const T* s = p.s;
+      const T* c = p.c;
+      b[0][0] = a[1][1] * c[5] - a[1][2] * c[4] + a[1][3] * c[3];
+      b[0][1] = -a[0][1] * c[5] + a[0][2] * c[4] - a[0][3] * c[3];
+      b[0][2] = a[3][1] * s[5] - a[3][2] * s[4] + a[3][3] * s[3];
+      b[0][3] = -a[2][1] * s[5] + a[2][2] * s[4] - a[2][3] * s[3];
+      b[1][0] = -a[1][0] * c[5] + a[1][2] * c[2] - a[1][3] * c[1];
+      b[1][1] = a[0][0] * c[5] - a[0][2] * c[2] + a[0][3] * c[1];
+      b[1][2] = -a[3][0] * s[5] + a[3][2] * s[2] - a[3][3] * s[1];
+      b[1][3] = a[2][0] * s[5] - a[2][2] * s[2] + a[2][3] * s[1];
+      b[2][0] = a[1][0] * c[4] - a[1][1] * c[2] + a[1][3] * c[0];
+      b[2][1] = -a[0][0] * c[4] + a[0][1] * c[2] - a[0][3] * c[0];
+      b[2][2] = a[3][0] * s[4] - a[3][1] * s[2] + a[3][3] * s[0];
+      b[2][3] = -a[2][0] * s[4] + a[2][1] * s[2] - a[2][3] * s[0];
+      b[3][0] = -a[1][0] * c[3] + a[1][1] * c[1] - a[1][2] * c[0];
+      b[3][1] = a[0][0] * c[3] - a[0][1] * c[1] + a[0][2] * c[0];
+      b[3][2] = -a[3][0] * s[3] + a[3][1] * s[1] - a[3][2] * s[0];
+      b[3][3] = a[2][0] * s[3] - a[2][1] * s[1] + a[2][2] * s[0];
+    }
+    return r;
+  }
+
+  static constexpr void checkIndex(int row, int col) {
+    if (C <= col || R <= row || row < 0 || col < 0) {
+      throw std::out_of_range("Error: out of range");
+    }
+  }
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_FIXED_MATRIX_H
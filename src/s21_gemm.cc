@@ -0,0 +1,198 @@
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "s21_kernels.h"
+
+namespace s21::kernels {
+
+namespace {
+
+// Register block of the micro-kernel and cache blocks of the packed panels:
+// a kKc x kNr sliver of B stays in L1, the kMc x kKc block of A in L2.
+constexpr int kMr = 4;
+constexpr int kNr = 8;
+constexpr int kKc = kGemmDepth;
+constexpr int kMc = 96;
+constexpr int kNc = 4096;
+
+// Packs an mc x kc block of A into kMr-row slivers, each stored column by
+// column, zero-filling the rows of the last sliver past mc.
+void PackA(int mc, int kc, Strided a, double* packed) {
+  for (int i = 0; i < mc; i += kMr) {
+    const int rows = std::min(kMr, mc - i);
+    for (int p = 0; p < kc; p++) {
+      int r = 0;
+      for (; r < rows; r++) packed[r] = *a.At(i + r, p);
+      for (; r < kMr; r++) packed[r] = 0;
+      packed += kMr;
+    }
+  }
+}
+
+// Packs a kc x nc block of B into kNr-column slivers, each stored row by row.
+void PackB(int kc, int nc, Strided b, double* packed) {
+  for (int j = 0; j < nc; j += kNr) {
+    const int cols = std::min(kNr, nc - j);
+    for (int p = 0; p < kc; p++) {
+      const double* row = b.At(p, j);
+      int c = 0;
+      if (b.col_stride == 1) {
+        for (; c < cols; c++) packed[c] = row[c];
+      } else {
+        for (; c < cols; c++) packed[c] = row[c * b.col_stride];
+      }
+      for (; c < kNr; c++) packed[c] = 0;
+      packed += kNr;
+    }
+  }
+}
+
+// kMr x kNr tile of C (+)= packed A sliver * packed B sliver.
+void MicroKernel(int kc, const double* __restrict pa,
+                 const double* __restrict pb, double* __restrict c, int ldc,
+                 bool accumulate) {
+  double acc[kMr][kNr] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < kMr; i++) {
+      const double ai = pa[i];
+      for (int j = 0; j < kNr; j++) acc[i][j] += ai * pb[j];
+    }
+    pa += kMr;
+    pb += kNr;
+  }
+  for (int i = 0; i < kMr; i++) {
+    double* row = c + static_cast<std::size_t>(i) * ldc;
+    if (accumulate) {
+      for (int j = 0; j < kNr; j++) row[j] += acc[i][j];
+    } else {
+      for (int j = 0; j < kNr; j++) row[j] = acc[i][j];
+    }
+  }
+}
+
+// Same tile with FMA: two 4-wide accumulators per row, eight in flight.
+__attribute__((target("avx2,fma"))) void MicroKernelAvx2(
+    int kc, const double* __restrict pa, const double* __restrict pb,
+    double* __restrict c, int ldc, bool accumulate) {
+  __m256d acc[kMr][2];
+  for (int i = 0; i < kMr; i++) {
+    acc[i][0] = _mm256_setzero_pd();
+    acc[i][1] = _mm256_setzero_pd();
+  }
+  for (int p = 0; p < kc; p++) {
+    const __m256d b0 = _mm256_loadu_pd(pb);
+    const __m256d b1 = _mm256_loadu_pd(pb + 4);
+    for (int i = 0; i < kMr; i++) {
+      const __m256d ai = _mm256_broadcast_sd(pa + i);
+      acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+    }
+    pa += kMr;
+    pb += kNr;
+  }
+  for (int i = 0; i < kMr; i++) {
+    double* row = c + static_cast<std::size_t>(i) * ldc;
+    if (accumulate) {
+      acc[i][0] = _mm256_add_pd(acc[i][0], _mm256_loadu_pd(row));
+      acc[i][1] = _mm256_add_pd(acc[i][1], _mm256_loadu_pd(row + 4));
+    }
+    _mm256_storeu_pd(row, acc[i][0]);
+    _mm256_storeu_pd(row + 4, acc[i][1]);
+  }
+}
+
+using MicroKernelFn = void (*)(int, const double*, const double*, double*, int,
+                               bool);
+
+void MacroKernel(int mc, int nc, int kc, const double* pa, const double* pb,
+                 double* c, int ldc, bool accumulate) {
+  const MicroKernelFn micro = ActiveSimdLevel() >= SimdLevel::kAvx2
+                                  ? MicroKernelAvx2
+                                  : MicroKernel;
+  double edge[kMr * kNr];
+  for (int j = 0; j < nc; j += kNr) {
+    const int cols = std::min(kNr, nc - j);
+    for (int i = 0; i < mc; i += kMr) {
+      const int rows = std::min(kMr, mc - i);
+      const double* a = pa + static_cast<std::size_t>(i) * kc;
+      const double* b = pb + static_cast<std::size_t>(j) * kc;
+      double* tile = c + static_cast<std::size_t>(i) * ldc + j;
+      if (rows == kMr && cols == kNr) {
+        micro(kc, a, b, tile, ldc, accumulate);
+        continue;
+      }
+      micro(kc, a, b, edge, kNr, false);
+      for (int r = 0; r < rows; r++) {
+        double* row = tile + static_cast<std::size_t>(r) * ldc;
+        for (int s = 0; s < cols; s++) {
+          row[s] = accumulate ? row[s] + edge[r * kNr + s] : edge[r * kNr + s];
+        }
+      }
+    }
+  }
+}
+
+void GemmSerial(int m, int n, int k, Strided a, Strided b, double* c, int ldc,
+                bool accumulate) {
+  if (k <= 0) {
+    for (int i = 0; i < m && !accumulate; i++) {
+      std::memset(c + static_cast<std::size_t>(i) * ldc, 0,
+                  sizeof(double) * n);
+    }
+    return;
+  }
+  const int nc_max = std::min(kNc, (n + kNr - 1) / kNr * kNr);
+  const int kc_max = std::min(kKc, k);
+  double* pb = Scratch<double>(static_cast<std::size_t>(kc_max) * nc_max,
+                               kScratchPackB);
+  double* pa =
+      Scratch<double>(static_cast<std::size_t>(kMc) * kc_max, kScratchPackA);
+  for (int jc = 0; jc < n; jc += kNc) {
+    const int nc = std::min(kNc, n - jc);
+    for (int pc = 0; pc < k; pc += kKc) {
+      const int kc = std::min(kKc, k - pc);
+      const bool add = accumulate || pc > 0;
+      PackB(kc, nc, b.Offset(pc, jc), pb);
+      for (int ic = 0; ic < m; ic += kMc) {
+        const int mc = std::min(kMc, m - ic);
+        PackA(mc, kc, a.Offset(ic, pc), pa);
+        MacroKernel(mc, nc, kc, pa, pb,
+                    c + static_cast<std::size_t>(ic) * ldc + jc, ldc, add);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void Gemm(int m, int n, int k, Strided a, Strided b, double* c, int ldc,
+          bool accumulate) noexcept {
+  if (m <= 0 || n <= 0) return;
+  const std::size_t flops = 2 * static_cast<std::size_t>(m) * n * k;
+  CountFlops(S21Instrumentation::kGemm, flops);
+  // output tiles are independent: split the taller side of C, every chunk
+  // packs its own panels into the scratch of the thread running it
+  if (m >= n) {
+    ParallelFor((m + kMc - 1) / kMc, 1, flops,
+                [=](std::size_t begin, std::size_t end) {
+                  const int i0 = static_cast<int>(begin) * kMc;
+                  const int i1 = std::min(m, static_cast<int>(end) * kMc);
+                  GemmSerial(i1 - i0, n, k, a.Offset(i0, 0), b,
+                             c + static_cast<std::size_t>(i0) * ldc, ldc,
+                             accumulate);
+                });
+  } else {
+    const int block = 8 * kNr;
+    ParallelFor((n + block - 1) / block, 1, flops,
+                [=](std::size_t begin, std::size_t end) {
+                  const int j0 = static_cast<int>(begin) * block;
+                  const int j1 = std::min(n, static_cast<int>(end) * block);
+                  GemmSerial(m, j1 - j0, k, a, b.Offset(0, j0), c + j0, ldc,
+                             accumulate);
+                });
+  }
+}
+
+}  // namespace s21::kernels
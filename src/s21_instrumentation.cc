@@ -0,0 +1,76 @@
+#include "s21_instrumentation.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "s21_kernels.h"
+
+namespace {
+
+thread_local S21Instrumentation::Counters counters = {};
+
+// swapped atomically, so a callback running on one thread survives another
+// thread replacing it
+std::shared_ptr<const S21Instrumentation::Callback> active_callback;
+
+}  // namespace
+
+namespace s21::kernels {
+
+#ifdef S21_MATRIX_INSTRUMENT
+S21Instrumentation::Counters& LocalCounters() noexcept { return counters; }
+
+namespace {
+
+std::int64_t Now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+TimedOperation::TimedOperation(
+    S21Instrumentation::Operation operation) noexcept
+    : operation_(operation), start_(Now()) {}
+
+TimedOperation::~TimedOperation() {
+  const std::uint64_t elapsed = static_cast<std::uint64_t>(Now() - start_);
+  counters.calls[operation_]++;
+  counters.nanoseconds[operation_] += elapsed;
+  const auto current = std::atomic_load(&active_callback);
+  if (current != nullptr) (*current)(operation_, elapsed);
+}
+#endif
+
+}  // namespace s21::kernels
+
+S21Instrumentation::Counters S21Instrumentation::Snapshot() noexcept {
+  return counters;
+}
+
+void S21Instrumentation::Reset() noexcept { counters = {}; }
+
+void S21Instrumentation::SetCallback(Callback callback) {
+  std::shared_ptr<const Callback> next;
+  if (callback) next = std::make_shared<const Callback>(std::move(callback));
+  std::atomic_store(&active_callback, std::move(next));
+}
+
+const char* S21Instrumentation::Name(Kernel kernel) noexcept {
+  static const char* const kNames[kKernels] = {
+      "gemm", "strassen", "lu",    "cholesky",
+      "qr",   "invert",   "solve", "elementwise"};
+  return kernel >= 0 && kernel < kKernels ? kNames[kernel] : "unknown";
+}
+
+const char* S21Instrumentation::Name(Operation operation) noexcept {
+  static const char* const kNames[kOperations] = {
+      "copy",        "sum_matrix",       "sub_matrix",
+      "mul_number",  "mul_matrix",       "transpose",
+      "determinant", "calc_complements", "inverse_matrix",
+      "expression"};
+  return operation >= 0 && operation < kOperations ? kNames[operation]
+                                                   : "unknown";
+}
@@ -0,0 +1,81 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_INSTRUMENTATION_H
+#define CPP1_S21_MATRIXPLUS_S21_INSTRUMENTATION_H
+
+#include <cstdint>
+#include <functional>
+
+// Counters of what S21Matrix operations cost: allocations, element copies,
+// floating point operations per kernel and wall time per operation. They
+// are compiled out unless the library and the code using it are built with
+// S21_MATRIX_INSTRUMENT defined (make INSTRUMENT=1 ...); otherwise every
+// hook is empty and Snapshot() stays zero.
+//
+// The counters are per thread. Each one is charged to the thread that
+// called into the library. The exception is allocations, which count on
+// the thread that made them, so pool threads growing their scratch keep
+// their own. Flop counts are the nominal ones of each kernel, e.g.
+// 2 m n k for a product, whatever the instruction set or blocking.
+class S21Instrumentation {
+ public:
+  enum Kernel {
+    kGemm,
+    // the block additions of the Strassen-Winograd recursion
+    kStrassen,
+    kLu,
+    kCholesky,
+    kQr,
+    kInvert,
+    // triangular solves against an LU factorization
+    kSolve,
+    // sums, differences and scaling
+    kElementwise,
+    kKernels
+  };
+
+  enum Operation {
+    kCopy,
+    kSumMatrix,
+    kSubMatrix,
+    kMulNumber,
+    kMulMatrix,
+    kTranspose,
+    kDeterminant,
+    kCalcComplements,
+    kInverseMatrix,
+    // evaluation of a lazy a + b - c * 2.0 into a matrix
+    kExpression,
+    kOperations
+  };
+
+  struct Counters {
+    // buffers from S21MatrixAllocator and scratch growth
+    std::uint64_t allocations;
+    std::uint64_t allocated_bytes;
+    // elements copied by the copy constructor and copy assignment
+    std::uint64_t element_copies;
+    std::uint64_t flops[kKernels];
+    std::uint64_t calls[kOperations];
+    std::uint64_t nanoseconds[kOperations];
+  };
+
+  // called on the finishing thread after every counted operation, nested
+  // ones included; Snapshot() from inside it sees the updated totals
+  using Callback =
+      std::function<void(Operation operation, std::uint64_t nanoseconds)>;
+
+#ifdef S21_MATRIX_INSTRUMENT
+  static constexpr bool kEnabled = true;
+#else
+  static constexpr bool kEnabled = false;
+#endif
+
+  // counters of the calling thread
+  static Counters Snapshot() noexcept;
+  static void Reset() noexcept;
+  // process-wide; an empty callback removes the current one
+  static void SetCallback(Callback callback);
+  static const char* Name(Kernel kernel) noexcept;
+  static const char* Name(Operation operation) noexcept;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_INSTRUMENTATION_H
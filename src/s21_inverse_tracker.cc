@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+// constructors
+S21InverseTracker::S21InverseTracker(const S21Matrix& matrix,
+                                     int refactor_interval, int drift_interval)
+    : matrix_(matrix),
+      determinant_(0),
+      singular_(false),
+      refactor_interval_(0),
+      drift_interval_(0),
+      since_refactor_(0),
+      since_check_(0),
+      refactors_(0),
+      drift_failures_(0),
+      probe_seed_(0x9e3779b97f4a7c15u) {
+  if (matrix_.GetRows() != matrix_.GetCols()) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+  SetRefactorInterval(refactor_interval);
+  SetDriftInterval(drift_interval);
+  column_.resize(GetSize());
+  row_.resize(GetSize());
+  Refactor();
+}
+
+// methods
+void S21InverseTracker::SetElement(int row, int col, double value) {
+  checkIndex(row);
+  checkIndex(col);
+  const double delta = value - matrix_(row, col);
+  if (delta == 0) return;
+  matrix_(row, col) = value;
+  if (singular_) {
+    Refactor();
+    return;
+  }
+  // u = e_row, v = delta e_col
+  const int n = GetSize();
+  const double* inverse_row = inverse_.RowData(col);
+  for (int i = 0; i < n; i++) {
+    column_[i] = inverse_(i, row);
+    row_[i] = delta * inverse_row[i];
+  }
+  Update(row_[row]);
+}
+
+void S21InverseTracker::SetRow(int row, const std::vector<double>& values) {
+  checkIndex(row);
+  checkLength(values);
+  // u = e_row, v = values - A(row, :)
+  const int n = GetSize();
+  double* target = matrix_.RowData(row);
+  std::fill(row_.begin(), row_.end(), 0.0);
+  for (int k = 0; k < n; k++) {
+    const double delta = values[k] - target[k];
+    target[k] = values[k];
+    if (delta == 0 || singular_) continue;
+    const double* inverse_row = inverse_.RowData(k);
+    for (int j = 0; j < n; j++) row_[j] += delta * inverse_row[j];
+  }
+  if (singular_) {
+    Refactor();
+    return;
+  }
+  for (int i = 0; i < n; i++) column_[i] = inverse_(i, row);
+  Update(row_[row]);
+}
+
+void S21InverseTracker::SetCol(int col, const std::vector<double>& values) {
+  checkIndex(col);
+  checkLength(values);
+  // u = values - A(:, col), v = e_col
+  const int n = GetSize();
+  std::vector<double> u(n);
+  for (int i = 0; i < n; i++) {
+    u[i] = values[i] - matrix_(i, col);
+    matrix_(i, col) = values[i];
+  }
+  if (singular_) {
+    Refactor();
+    return;
+  }
+  for (int i = 0; i < n; i++) {
+    const double* inverse_row = inverse_.RowData(i);
+    double sum = 0;
+    for (int j = 0; j < n; j++) sum += inverse_row[j] * u[j];
+    column_[i] = sum;
+  }
+  const double* inverse_row = inverse_.RowData(col);
+  std::copy(inverse_row, inverse_row + n, row_.begin());
+  Update(column_[col]);
+}
+
+void S21InverseTracker::RankOneUpdate(const std::vector<double>& u,
+                                      const std::vector<double>& v) {
+  checkLength(u);
+  checkLength(v);
+  const int n = GetSize();
+  for (int i = 0; i < n; i++) {
+    double* target = matrix_.RowData(i);
+    for (int j = 0; j < n; j++) target[j] += u[i] * v[j];
+  }
+  if (singular_) {
+    Refactor();
+    return;
+  }
+  std::fill(row_.begin(), row_.end(), 0.0);
+  double dot = 0;
+  for (int i = 0; i < n; i++) {
+    const double* inverse_row = inverse_.RowData(i);
+    double sum = 0;
+    for (int j = 0; j < n; j++) {
+      sum += inverse_row[j] * u[j];
+      row_[j] += v[i] * inverse_row[j];
+    }
+    column_[i] = sum;
+    dot += v[i] * sum;
+  }
+  Update(dot);
+}
+
+void S21InverseTracker::Refactor() {
+  const S21LuFactorization lu(matrix_);
+  singular_ = lu.IsSingular();
+  determinant_ = singular_ ? 0 : lu.Determinant();
+  if (!singular_) inverse_ = lu.InverseMatrix();
+  refactors_++;
+  since_refactor_ = 0;
+  since_check_ = 0;
+}
+
+bool S21InverseTracker::CheckDrift() {
+  since_check_ = 0;
+  if (singular_) return true;
+  const int n = GetSize();
+  // p in [-1, 1), from a 64-bit linear congruential generator
+  S21Matrix probe(n, 1), solution(n, 1), image(n, 1);
+  for (int i = 0; i < n; i++) {
+    probe_seed_ = probe_seed_ * 6364136223846793005u + 1442695040888963407u;
+    probe(i, 0) = static_cast<double>(probe_seed_ >> 11) * 0x1p-52 - 1;
+  }
+  s21::kernels::Gemm(n, 1, n, inverse_.Data(), inverse_.Stride(),
+                     probe.Data(), probe.Stride(), solution.Data(),
+                     solution.Stride(), false);
+  s21::kernels::Gemm(n, 1, n, matrix_.Data(), matrix_.Stride(),
+                     solution.Data(), solution.Stride(), image.Data(),
+                     image.Stride(), false);
+  if (image.EqMatrix(probe)) return true;
+  drift_failures_++;
+  Refactor();
+  return false;
+}
+
+// accessors
+const S21Matrix& S21InverseTracker::GetInverse() const {
+  if (singular_) throw std::out_of_range("Error: determinant = 0");
+  return inverse_;
+}
+
+void S21InverseTracker::SetRefactorInterval(int updates) {
+  if (updates < 0) throw std::out_of_range("Error: out of range");
+  refactor_interval_ = updates;
+}
+
+void S21InverseTracker::SetDriftInterval(int updates) {
+  if (updates < 0) throw std::out_of_range("Error: out of range");
+  drift_interval_ = updates;
+}
+
+// private methods
+void S21InverseTracker::Update(double dot) {
+  const double denominator = 1 + dot;
+  // the new inverse loses about log10((1 + |dot|) / |denominator|) digits
+  // to the cancellation; past half of them, start over
+  const double cancellation = std::fabs(denominator) / (1 + std::fabs(dot));
+  if (cancellation <= std::sqrt(std::numeric_limits<double>::epsilon())) {
+    Refactor();
+    return;
+  }
+  // A^-1 -= (A^-1 u)(v^T A^-1) / (1 + v^T A^-1 u)
+  const int n = GetSize();
+  const double scale = 1 / denominator;
+  S21Matrix& inverse = inverse_;
+  const double* column = column_.data();
+  const double* row = row_.data();
+  s21::kernels::ParallelFor(
+      n, 64, 2 * static_cast<std::size_t>(n) * n,
+      [&inverse, column, row, scale, n](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          double* target = inverse.RowData(static_cast<int>(i));
+          const double factor = column[i] * scale;
+          for (int j = 0; j < n; j++) target[j] -= factor * row[j];
+        }
+      });
+  determinant_ *= denominator;
+  since_refactor_++;
+  since_check_++;
+  if (refactor_interval_ > 0 && since_refactor_ >= refactor_interval_) {
+    Refactor();
+  } else if (drift_interval_ > 0 && since_check_ >= drift_interval_) {
+    CheckDrift();
+  }
+}
+
+void S21InverseTracker::checkIndex(int index) const {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("Error: out of range");
+  }
+}
+
+void S21InverseTracker::checkLength(const std::vector<double>& values) const {
+  if (static_cast<int>(values.size()) != GetSize()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+}
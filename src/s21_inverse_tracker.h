@@ -0,0 +1,82 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_INVERSE_TRACKER_H
+#define CPP1_S21_MATRIXPLUS_S21_INVERSE_TRACKER_H
+
+// A square matrix whose inverse and determinant are kept current as the
+// matrix changes. An element, row, column or general rank-1 change
+// A + u v^T costs O(n^2): the inverse follows the Sherman-Morrison formula,
+// and the determinant follows the matrix determinant lemma,
+// det(A + u v^T) = det(A) (1 + v^T A^-1 u). Rounding errors build up from one
+// update to the next. To bound the drift, the tracker refactors from
+// scratch every GetRefactorInterval() updates. Every GetDriftInterval()
+// updates it also checks that A (A^-1 p) EqMatrix p for a pseudo-random
+// vector p, in O(n^2), and refactors when the check fails. When the
+// denominator 1 + v^T A^-1 u nearly cancels, the update would lose most of
+// its digits, so the tracker refactors instead. While the matrix is
+// singular, GetInverse() throws std::out_of_range and updates refactor.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <cstdint>
+#include <vector>
+
+class S21InverseTracker {
+ public:
+  // constructors; throw std::invalid_argument for a non-square matrix
+  explicit S21InverseTracker(const S21Matrix& matrix,
+                             int refactor_interval = 100,
+                             int drift_interval = 10);
+
+  // methods
+  // A(row, col) = value
+  void SetElement(int row, int col, double value);
+  // row or column index of A replaced with values
+  void SetRow(int row, const std::vector<double>& values);
+  void SetCol(int col, const std::vector<double>& values);
+  // A += u v^T
+  void RankOneUpdate(const std::vector<double>& u,
+                     const std::vector<double>& v);
+  // recomputes the inverse and the determinant from A
+  void Refactor();
+  // the drift check described above; false when it failed and the
+  // tracker refactored
+  bool CheckDrift();
+
+  // accessors
+  int GetSize() const noexcept { return matrix_.GetRows(); }
+  const S21Matrix& GetMatrix() const noexcept { return matrix_; }
+  const S21Matrix& GetInverse() const;
+  double Determinant() const noexcept { return determinant_; }
+  bool IsSingular() const noexcept { return singular_; }
+  // updates between full refactorizations and between drift checks;
+  // 0 turns either off. Throw std::out_of_range for a negative count.
+  int GetRefactorInterval() const noexcept { return refactor_interval_; }
+  void SetRefactorInterval(int updates);
+  int GetDriftInterval() const noexcept { return drift_interval_; }
+  void SetDriftInterval(int updates);
+  // full factorizations so far, the one at construction included
+  std::uint64_t GetRefactorCount() const noexcept { return refactors_; }
+  std::uint64_t GetDriftFailures() const noexcept { return drift_failures_; }
+
+ private:
+  S21Matrix matrix_;
+  S21Matrix inverse_;
+  double determinant_;
+  bool singular_;
+  int refactor_interval_;
+  int drift_interval_;
+  int since_refactor_;
+  int since_check_;
+  std::uint64_t refactors_;
+  std::uint64_t drift_failures_;
+  std::uint64_t probe_seed_;
+  // A^-1 u and v^T A^-1 of the pending update
+  std::vector<double> column_, row_;
+
+  // applies the pending update, with v^T A^-1 u = dot, to the inverse and
+  // the determinant, then refactors or checks drift when due; matrix_ must
+  // already hold the updated matrix
+  void Update(double dot);
+  void checkIndex(int index) const;
+  void checkLength(const std::vector<double>& values) const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_INVERSE_TRACKER_H
@@ -0,0 +1,243 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_KERNELS_H
+#define CPP1_S21_MATRIXPLUS_S21_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "s21_instrumentation.h"
+
+// Internal building blocks shared by S21Matrix and the decompositions.
+// Matrices are passed as a row-major pointer plus a leading dimension (the
+// distance between rows, in elements), the same layout S21Matrix stores.
+namespace s21::kernels {
+
+// Per-thread scratch memory, reused between calls so that the hot paths do
+// not allocate. Each slot is an independent buffer that only grows; a pointer
+// stays valid until the next request for the same slot on the same thread.
+enum ScratchSlot {
+  kScratchFactor,
+  kScratchPivots,
+  kScratchPackA,
+  kScratchPackB,
+  kScratchRows,
+  kScratchPanel,
+  kScratchSlots
+};
+
+void* ScratchBytes(std::size_t bytes, ScratchSlot slot);
+
+template <typename T>
+T* Scratch(std::size_t count, ScratchSlot slot) {
+  return static_cast<T*>(ScratchBytes(count * sizeof(T), slot));
+}
+
+// Splits [0, count) into chunks of at least grain items and calls
+// body(begin, end) for each, on the shared thread pool when the estimated
+// flops reach S21Parallel's serial threshold. Calls made from inside a chunk
+// run serially. body must not throw.
+using RangeFn = void (*)(void* ctx, std::size_t begin, std::size_t end);
+
+void ParallelForImpl(std::size_t count, std::size_t grain, std::size_t flops,
+                     RangeFn fn, void* ctx);
+
+template <typename Body>
+void ParallelFor(std::size_t count, std::size_t grain, std::size_t flops,
+                 const Body& body) {
+  ParallelForImpl(
+      count, grain, flops,
+      [](void* ctx, std::size_t begin, std::size_t end) {
+        (*static_cast<const Body*>(ctx))(begin, end);
+      },
+      const_cast<Body*>(&body));
+}
+
+// Marks the current thread as running inside a parallel chunk while alive.
+class RunSerially {
+ public:
+  RunSerially() noexcept;
+  ~RunSerially();
+  RunSerially(const RunSerially&) = delete;
+  RunSerially& operator=(const RunSerially&) = delete;
+
+ private:
+  bool previous_;
+};
+
+// Instruction set the elementwise and GEMM kernels run on. Detected from the
+// CPU at startup; S21_MATRIX_SIMD=scalar|sse2|avx2|avx512 in the environment
+// caps it, so the vector paths can be A/B tested against the scalar ones.
+enum class SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+SimdLevel ActiveSimdLevel() noexcept;
+// Switches the kernels at run time, clamped to what the CPU supports.
+// Returns the level actually selected.
+SimdLevel SetSimdLevel(SimdLevel level) noexcept;
+
+struct ElementwiseKernels {
+  void (*add)(double* a, const double* b, std::size_t n);
+  void (*sub)(double* a, const double* b, std::size_t n);
+  void (*scale)(double* a, double s, std::size_t n);
+  // true when |a[i] - b[i]| <= eps for every i
+  bool (*near)(const double* a, const double* b, std::size_t n, double eps);
+  // b (cols x rows) = transpose of a (rows x cols)
+  void (*transpose)(const double* a, int lda, double* b, int ldb, int rows,
+                    int cols);
+};
+
+const ElementwiseKernels& Elementwise() noexcept;
+
+// Transposes the n x n matrix a in place with a cache-oblivious recursion;
+// the blocks at the bottom go through the transpose kernel.
+void TransposeInPlace(double* a, int n, int lda) noexcept;
+
+// Read-only operand addressed as data[i * row_stride + j * col_stride]; a
+// transposed operand is the same memory with the strides swapped.
+struct Strided {
+  const double* data;
+  std::ptrdiff_t row_stride;
+  std::ptrdiff_t col_stride;
+
+  const double* At(int i, int j) const noexcept {
+    return data + i * row_stride + j * col_stride;
+  }
+  Strided Offset(int i, int j) const noexcept {
+    return {At(i, j), row_stride, col_stride};
+  }
+};
+
+constexpr int kGemmDepth = 256;
+
+// C = A * B (or C += A * B when accumulate is set) for an m x k matrix A
+// and a k x n matrix B. Cache-blocked: panels of A and B are packed into
+// contiguous scratch buffers and consumed by a register-blocked micro-kernel.
+// C must not overlap A or B. Every element of C sums its kGemmDepth-deep
+// slices of the k dimension one after another, so splitting k at multiples
+// of kGemmDepth and accumulating gives bit-identical results.
+void Gemm(int m, int n, int k, Strided a, Strided b, double* c, int ldc,
+          bool accumulate) noexcept;
+
+inline void Gemm(int m, int n, int k, const double* a, int lda,
+                 const double* b, int ldb, double* c, int ldc,
+                 bool accumulate) noexcept {
+  Gemm(m, n, k, Strided{a, lda, 1}, Strided{b, ldb, 1}, c, ldc, accumulate);
+}
+
+// Order of the zero-padded matrices StrassenGemm works on: the smallest
+// n0 * 2^d >= n with n0 <= crossover. Sets *levels to d when given.
+int StrassenOrder(int n, int crossover, int* levels = nullptr) noexcept;
+// Doubles of workspace StrassenGemm needs for an n x n product.
+std::size_t StrassenWorkspace(int n, int crossover) noexcept;
+// C = A * B for n x n matrices by Strassen-Winograd recursion down to
+// blocks of at most crossover, which go to Gemm. C must not overlap A or
+// B; workspace holds StrassenWorkspace(n, crossover) doubles.
+void StrassenGemm(int n, const double* a, int lda, const double* b, int ldb,
+                  double* c, int ldc, int crossover,
+                  double* workspace) noexcept;
+
+// In-place LU factorization with partial pivoting, P * A = L * U, of the
+// n x n matrix a. L has a unit diagonal and is stored below it, U on and
+// above it; row k was swapped with row pivots[k]. Returns the sign of the
+// permutation, or 0 if an exactly zero pivot column was met.
+int LuFactor(double* a, int n, int lda, int* pivots) noexcept;
+// the same in single precision, for mixed-precision refinement
+int LuFactor(float* a, int n, int lda, int* pivots) noexcept;
+
+// Solves T X = B in place for the n x k block b (leading dimension ldb),
+// where T is the lower or upper triangle of t, with ones in place of its
+// diagonal when unit_diagonal is set; a transposed t solves against the
+// other triangle's transpose. Wide blocks are split into column slabs
+// solved in parallel, and within a slab the off-diagonal part of the
+// triangle is applied with Gemm, a block of rows at a time. The diagonal
+// must have no zero.
+void TriangularSolve(Strided t, int n, bool lower, bool unit_diagonal,
+                     double* b, int k, int ldb) noexcept;
+
+// Solves A X = B in place given LuFactor's output for A: b is permuted,
+// then swept by the unit lower and the upper triangle.
+void LuSolve(const double* lu, int n, int ldlu, const int* pivots, double* b,
+             int k, int ldb) noexcept;
+// single precision, without the Gemm blocking
+void LuSolve(const float* lu, int n, int ldlu, const int* pivots, float* b,
+             int k, int ldb) noexcept;
+
+// In-place blocked Cholesky factorization A = L L^T of the symmetric n x n
+// matrix a, of which only the lower triangle is read. L overwrites it and
+// the strict upper triangle is zeroed. Panels of kCholeskyBlock columns
+// are factored directly; the trailing update, two thirds of the work,
+// goes through Gemm. Returns false, with a in an unspecified state, when
+// a pivot is not positive: the matrix is not positive definite.
+constexpr int kCholeskyBlock = 64;
+
+bool CholeskyFactor(double* a, int n, int lda) noexcept;
+
+// In-place Householder QR factorization A = Q R of the m x n matrix a,
+// m >= n. R is left on and above the diagonal; the reflectors
+// H_j = I - tau[j] v_j v_j^T with Q = H_0 ... H_{n-1} keep v_j below it,
+// their unit leading element implied. Panels of kQrBlock columns are
+// factored directly, then aggregated as I - Y T Y^T so that the update of
+// the columns to their right goes through Gemm.
+constexpr int kQrBlock = 32;
+
+void QrFactor(double* a, int m, int n, int lda, double* tau) noexcept;
+
+// b = Q^T b (transpose) or b = Q b for the m x k block b and QrFactor's
+// output for an m x n matrix.
+void QrApply(const double* qr, int m, int n, int ldqr, const double* tau,
+             bool transpose, double* b, int k, int ldb) noexcept;
+
+// In-place Gauss-Jordan inversion with partial pivoting of the n x n matrix
+// a; pivots needs room for n ints. A pivot whose magnitude does not exceed
+// n * machine epsilon * max|a_ij| is treated as zero: the function returns
+// false and leaves a in an unspecified state.
+bool InvertInPlace(double* a, int n, int lda, int* pivots) noexcept;
+
+// Instrumentation hooks, see s21_instrumentation.h. Without
+// S21_MATRIX_INSTRUMENT they are empty and compile to nothing.
+#ifdef S21_MATRIX_INSTRUMENT
+S21Instrumentation::Counters& LocalCounters() noexcept;
+
+inline void CountAllocation(std::size_t bytes) noexcept {
+  S21Instrumentation::Counters& counters = LocalCounters();
+  counters.allocations++;
+  counters.allocated_bytes += bytes;
+}
+
+inline void CountCopies(std::size_t elements) noexcept {
+  LocalCounters().element_copies += elements;
+}
+
+inline void CountFlops(S21Instrumentation::Kernel kernel,
+                       std::size_t flops) noexcept {
+  LocalCounters().flops[kernel] += flops;
+}
+
+// Charges the wall time from construction to destruction to operation and
+// runs the callback; the callback must not throw.
+class TimedOperation {
+ public:
+  explicit TimedOperation(S21Instrumentation::Operation operation) noexcept;
+  ~TimedOperation();
+  TimedOperation(const TimedOperation&) = delete;
+  TimedOperation& operator=(const TimedOperation&) = delete;
+
+ private:
+  S21Instrumentation::Operation operation_;
+  std::int64_t start_;
+};
+#else
+inline void CountAllocation(std::size_t) noexcept {}
+inline void CountCopies(std::size_t) noexcept {}
+inline void CountFlops(S21Instrumentation::Kernel, std::size_t) noexcept {}
+
+class TimedOperation {
+ public:
+  explicit TimedOperation(S21Instrumentation::Operation) noexcept {}
+  ~TimedOperation() {}
+  TimedOperation(const TimedOperation&) = delete;
+  TimedOperation& operator=(const TimedOperation&) = delete;
+};
+#endif
+
+}  // namespace s21::kernels
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_KERNELS_H
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace s21::kernels {
+
+namespace {
+
+struct ScratchStore {
+  void* data[kScratchSlots] = {};
+  std::size_t bytes[kScratchSlots] = {};
+
+  ~ScratchStore() {
+    for (void* p : data) {
+      if (p != nullptr) {
+        ::operator delete(p, std::align_val_t(S21Matrix::kAlignment));
+      }
+    }
+  }
+};
+
+thread_local ScratchStore scratch_store;
+
+// Triangular solves go by blocks of kSolveBlock rows; right-hand sides
+// narrower than kSolveWide are swept row by row instead, since packing them
+// for Gemm does not pay off. Parallel slabs are kSolveSlab columns wide.
+constexpr int kSolveBlock = 64;
+constexpr int kSolveWide = 16;
+constexpr int kSolveSlab = 128;
+
+// b[i] -= t[i] for the rows x cols blocks b (ldb) and t (dense)
+void SubtractBlock(double* b, int ldb, const double* t, int rows, int cols) {
+  for (int i = 0; i < rows; i++) {
+    double* row = b + static_cast<std::size_t>(i) * ldb;
+    const double* from = t + static_cast<std::size_t>(i) * cols;
+    for (int j = 0; j < cols; j++) row[j] -= from[j];
+  }
+}
+
+// one right-hand side: every row of the triangle is a dot product
+void SolveColumn(Strided t, int n, bool lower, bool unit, double* b,
+                 int ldb) {
+  auto x = [=](int i) -> double& {
+    return b[static_cast<std::size_t>(i) * ldb];
+  };
+  for (int s = 0; s < n; s++) {
+    const int i = lower ? s : n - 1 - s;
+    const int p0 = lower ? 0 : i + 1, p1 = lower ? i : n;
+    const double* row = t.At(i, 0);
+    double sum = x(i);
+    if (t.col_stride == 1) {
+      for (int p = p0; p < p1; p++) sum -= row[p] * x(p);
+    } else {
+      for (int p = p0; p < p1; p++) sum -= row[p * t.col_stride] * x(p);
+    }
+    x(i) = unit ? sum : sum / *t.At(i, i);
+  }
+}
+
+// Substitution of a k-column slab, a block of rows at a time: the part of
+// the triangle left of (lower) or right of (upper) the block goes through
+// Gemm, the block's own triangle row by row.
+void SolveSlab(Strided t, int n, bool lower, bool unit, double* b, int k,
+               int ldb) {
+  const int nb = kSolveBlock;
+  double* tmp = nullptr;
+  if (k >= kSolveWide) {
+    tmp = Scratch<double>(static_cast<std::size_t>(nb) * k, kScratchRows);
+  }
+  auto b_row = [=](int i) { return b + static_cast<std::size_t>(i) * ldb; };
+  for (int s0 = 0; s0 < n; s0 += nb) {
+    const int i0 = lower ? s0 : std::max(0, n - s0 - nb);
+    const int i1 = lower ? std::min(n, s0 + nb) : n - s0;
+    // the solved rows this block depends on
+    const int d0 = lower ? 0 : i1, d1 = lower ? i0 : n;
+    const bool blocked = tmp != nullptr && d0 < d1;
+    if (blocked) {
+      Gemm(i1 - i0, k, d1 - d0, t.Offset(i0, d0), Strided{b_row(d0), ldb, 1},
+           tmp, k, false);
+      SubtractBlock(b_row(i0), ldb, tmp, i1 - i0, k);
+    }
+    for (int r = 0; r < i1 - i0; r++) {
+      const int i = lower ? i0 + r : i1 - 1 - r;
+      double* row = b_row(i);
+      // what Gemm has not covered: the rest of the row within the block
+      const int q0 = lower ? (blocked ? i0 : 0) : i + 1;
+      const int q1 = lower ? i : (blocked ? i1 : n);
+      for (int p = q0; p < q1; p++) {
+        const double f = *t.At(i, p);
+        const double* from = b_row(p);
+        if (f != 0) {
+          for (int j = 0; j < k; j++) row[j] -= f * from[j];
+        }
+      }
+      if (!unit) {
+        const double inv_pivot = 1.0 / *t.At(i, i);
+        for (int j = 0; j < k; j++) row[j] *= inv_pivot;
+      }
+    }
+  }
+}
+
+template <typename T>
+int LuFactorImpl(T* a, int n, int lda, int* pivots) {
+  // 2 r^2 + r for every trailing block of order r < n
+  const std::size_t order = n > 0 ? n : 0;
+  CountFlops(S21Instrumentation::kLu,
+             order * (order - 1) * (2 * order - 1) / 3 +
+                 order * (order - 1) / 2);
+  int sign = 1;
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    T best = std::fabs(a[static_cast<std::size_t>(k) * lda + k]);
+    for (int i = k + 1; i < n; i++) {
+      T v = std::fabs(a[static_cast<std::size_t>(i) * lda + k]);
+      if (v > best) {
+        best = v;
+        p = i;
+      }
+    }
+    pivots[k] = p;
+    if (best == 0) return 0;
+    T* row_k = a + static_cast<std::size_t>(k) * lda;
+    if (p != k) {
+      T* row_p = a + static_cast<std::size_t>(p) * lda;
+      for (int j = 0; j < n; j++) std::swap(row_k[j], row_p[j]);
+      sign = -sign;
+    }
+    const T inv_pivot = T(1) / row_k[k];
+    // trailing update: every row below the pivot is independent
+    const std::size_t rest = n - k - 1;
+    ParallelFor(rest, 16, 2 * rest * rest,
+                [=](std::size_t begin, std::size_t end) {
+                  for (std::size_t r = begin; r < end; r++) {
+                    T* row_i = a + (k + 1 + r) * lda;
+                    const T l = row_i[k] * inv_pivot;
+                    row_i[k] = l;
+                    for (int j = k + 1; j < n; j++) row_i[j] -= l * row_k[j];
+                  }
+                });
+  }
+  return sign;
+}
+
+// The float path of LuSolve: plain substitution, row by row, or by dot
+// products for a single right-hand side.
+template <typename T>
+void LuSolveRows(const T* lu, int n, int ldlu, T* b, int k, int ldb) {
+  auto lu_row = [=](int i) { return lu + static_cast<std::size_t>(i) * ldlu; };
+  auto b_row = [=](int i) { return b + static_cast<std::size_t>(i) * ldb; };
+  if (k == 1) {
+    for (int i = 0; i < n; i++) {
+      T sum = *b_row(i);
+      for (int p = 0; p < i; p++) sum -= lu_row(i)[p] * *b_row(p);
+      *b_row(i) = sum;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      T sum = *b_row(i);
+      for (int p = i + 1; p < n; p++) sum -= lu_row(i)[p] * *b_row(p);
+      *b_row(i) = sum / lu_row(i)[i];
+    }
+    return;
+  }
+  for (int i = 0; i < n; i++) {
+    for (int p = 0; p < i; p++) {
+      const T f = lu_row(i)[p];
+      if (f == 0) continue;
+      for (int j = 0; j < k; j++) b_row(i)[j] -= f * b_row(p)[j];
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    for (int p = i + 1; p < n; p++) {
+      const T f = lu_row(i)[p];
+      if (f == 0) continue;
+      for (int j = 0; j < k; j++) b_row(i)[j] -= f * b_row(p)[j];
+    }
+    const T inv_pivot = T(1) / lu_row(i)[i];
+    for (int j = 0; j < k; j++) b_row(i)[j] *= inv_pivot;
+  }
+}
+
+}  // namespace
+
+void* ScratchBytes(std::size_t bytes, ScratchSlot slot) {
+  ScratchStore& store = scratch_store;
+  if (store.bytes[slot] < bytes) {
+    std::size_t grown = store.bytes[slot] * 2;
+    if (grown < bytes) grown = bytes;
+    void* fresh =
+        ::operator new(grown, std::align_val_t(S21Matrix::kAlignment));
+    if (store.data[slot] != nullptr) {
+      ::operator delete(store.data[slot],
+                        std::align_val_t(S21Matrix::kAlignment));
+    }
+    CountAllocation(grown);
+    store.data[slot] = fresh;
+    store.bytes[slot] = grown;
+  }
+  return store.data[slot];
+}
+
+int LuFactor(double* a, int n, int lda, int* pivots) noexcept {
+  return LuFactorImpl(a, n, lda, pivots);
+}
+
+int LuFactor(float* a, int n, int lda, int* pivots) noexcept {
+  return LuFactorImpl(a, n, lda, pivots);
+}
+
+void TriangularSolve(Strided t, int n, bool lower, bool unit_diagonal,
+                     double* b, int k, int ldb) noexcept {
+  if (n <= 0 || k <= 0) return;
+  const std::size_t flops = static_cast<std::size_t>(n) * n * k;
+  CountFlops(S21Instrumentation::kSolve, flops);
+  if (k == 1) {
+    SolveColumn(t, n, lower, unit_diagonal, b, ldb);
+    return;
+  }
+  // columns of X are independent: slabs of them are solved in parallel,
+  // each with its own scratch
+  const int slab = kSolveSlab;
+  ParallelFor((k + slab - 1) / slab, 1, flops,
+              [=](std::size_t begin, std::size_t end) {
+                const int j0 = static_cast<int>(begin) * slab;
+                const int j1 = std::min(k, static_cast<int>(end) * slab);
+                SolveSlab(t, n, lower, unit_diagonal, b + j0, j1 - j0, ldb);
+              });
+}
+
+void LuSolve(const double* lu, int n, int ldlu, const int* pivots, double* b,
+             int k, int ldb) noexcept {
+  for (int i = 0; i < n && k > 0; i++) {
+    if (pivots[i] == i) continue;
+    double* row_i = b + static_cast<std::size_t>(i) * ldb;
+    double* row_p = b + static_cast<std::size_t>(pivots[i]) * ldb;
+    for (int j = 0; j < k; j++) std::swap(row_i[j], row_p[j]);
+  }
+  TriangularSolve(Strided{lu, ldlu, 1}, n, true, true, b, k, ldb);
+  TriangularSolve(Strided{lu, ldlu, 1}, n, false, false, b, k, ldb);
+}
+
+void LuSolve(const float* lu, int n, int ldlu, const int* pivots, float* b,
+             int k, int ldb) noexcept {
+  if (n <= 0 || k <= 0) return;
+  CountFlops(S21Instrumentation::kSolve,
+             2 * static_cast<std::size_t>(n) * n * k);
+  for (int i = 0; i < n; i++) {
+    if (pivots[i] == i) continue;
+    float* row_i = b + static_cast<std::size_t>(i) * ldb;
+    float* row_p = b + static_cast<std::size_t>(pivots[i]) * ldb;
+    for (int j = 0; j < k; j++) std::swap(row_i[j], row_p[j]);
+  }
+  // columns of X are independent
+  const int slab = kSolveSlab;
+  ParallelFor((k + slab - 1) / slab, 1,
+              2 * static_cast<std::size_t>(n) * n * k,
+              [=](std::size_t begin, std::size_t end) {
+                const int j0 = static_cast<int>(begin) * slab;
+                const int j1 = std::min(k, static_cast<int>(end) * slab);
+                LuSolveRows(lu, n, ldlu, b + j0, j1 - j0, ldb);
+              });
+}
+
+bool InvertInPlace(double* a, int n, int lda, int* pivots) noexcept {
+  // a scaled pivot row and n - 1 row updates per column
+  const std::size_t order = n > 0 ? n : 0;
+  CountFlops(S21Instrumentation::kInvert, order * order * (2 * order - 1));
+  double scale = 0;
+  for (int i = 0; i < n; i++) {
+    const double* row = a + static_cast<std::size_t>(i) * lda;
+    for (int j = 0; j < n; j++) scale = std::fmax(scale, std::fabs(row[j]));
+  }
+  const double tolerance = n * std::numeric_limits<double>::epsilon() * scale;
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    double best = std::fabs(a[static_cast<std::size_t>(k) * lda + k]);
+    for (int i = k + 1; i < n; i++) {
+      double v = std::fabs(a[static_cast<std::size_t>(i) * lda + k]);
+      if (v > best) {
+        best = v;
+        p = i;
+      }
+    }
+    pivots[k] = p;
+    if (best <= tolerance) return false;
+    double* row_k = a + static_cast<std::size_t>(k) * lda;
+    if (p != k) {
+      double* row_p = a + static_cast<std::size_t>(p) * lda;
+      for (int j = 0; j < n; j++) std::swap(row_k[j], row_p[j]);
+    }
+    const double inv_pivot = 1.0 / row_k[k];
+    row_k[k] = 1;
+    for (int j = 0; j < n; j++) row_k[j] *= inv_pivot;
+    ParallelFor(n, 16, 2 * static_cast<std::size_t>(n) * n,
+                [=](std::size_t begin, std::size_t end) {
+                  for (std::size_t i = begin; i < end; i++) {
+                    if (i == static_cast<std::size_t>(k)) continue;
+                    double* row_i = a + i * lda;
+                    const double f = row_i[k];
+                    if (f == 0) continue;
+                    row_i[k] = 0;
+                    for (int j = 0; j < n; j++) row_i[j] -= f * row_k[j];
+                  }
+                });
+  }
+  // row swaps of A become column swaps of the inverse, undone in reverse
+  for (int k = n - 1; k >= 0; k--) {
+    if (pivots[k] == k) continue;
+    for (int i = 0; i < n; i++) {
+      double* row = a + static_cast<std::size_t>(i) * lda;
+      std::swap(row[k], row[pivots[k]]);
+    }
+  }
+  return true;
+}
+
+}  // namespace s21::kernels
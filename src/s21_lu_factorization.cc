@@ -0,0 +1,101 @@
+#include <cmath>
+#include <limits>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+// constructors
+S21LuFactorization::S21LuFactorization(const S21Matrix& matrix)
+    : lu_(matrix) {
+  Factor();
+}
+
+S21LuFactorization::S21LuFactorization(S21Matrix&& matrix)
+    : lu_(std::move(matrix)) {
+  Factor();
+}
+
+// methods
+S21Matrix S21LuFactorization::Solve(const S21Matrix& b) const {
+  S21Matrix x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+std::vector<double> S21LuFactorization::Solve(
+    const std::vector<double>& b) const {
+  std::vector<double> x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+void S21LuFactorization::SolveInPlace(S21Matrix& b) const {
+  checkRows(b.GetRows());
+  SolveInPlace(b.Data(), b.GetCols(), b.Stride());
+}
+
+void S21LuFactorization::SolveInPlace(std::vector<double>& b) const {
+  checkRows(static_cast<int>(b.size()));
+  SolveInPlace(b.data(), 1, 1);
+}
+
+void S21LuFactorization::SolveInPlace(double* b, int cols, int ld) const {
+  if (cols < 0 || ld < cols) throw std::out_of_range("Error: out of range");
+  checkSolvable();
+  s21::kernels::LuSolve(lu_.Data(), GetSize(), lu_.Stride(), pivots_.data(),
+                        b, cols, ld);
+}
+
+double S21LuFactorization::Determinant() const noexcept {
+  double det = sign_;
+  for (int i = 0; i < GetSize() && sign_ != 0; i++) det *= lu_(i, i);
+  return det;
+}
+
+double S21LuFactorization::LogDeterminant(int& sign) const noexcept {
+  sign = sign_;
+  double res = 0;
+  for (int i = 0; i < GetSize() && sign != 0; i++) {
+    const double pivot = lu_(i, i);
+    if (pivot < 0) sign = -sign;
+    res += std::log(std::fabs(pivot));
+  }
+  return sign == 0 ? -HUGE_VAL : res;
+}
+
+S21Matrix S21LuFactorization::InverseMatrix() const {
+  checkSolvable();
+  const int n = GetSize();
+  S21Matrix inverse(n, n);
+  for (int i = 0; i < n; i++) inverse(i, i) = 1;
+  SolveInPlace(inverse);
+  return inverse;
+}
+
+// private methods
+void S21LuFactorization::Factor() {
+  const int n = lu_.GetRows();
+  if (n != lu_.GetCols()) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+  double scale = 0;
+  for (int i = 0; i < n; i++) {
+    const double* row = lu_.RowData(i);
+    for (int j = 0; j < n; j++) scale = std::fmax(scale, std::fabs(row[j]));
+  }
+  pivots_.assign(n, 0);
+  sign_ = s21::kernels::LuFactor(lu_.Data(), n, lu_.Stride(), pivots_.data());
+  const double tolerance = n * std::numeric_limits<double>::epsilon() * scale;
+  singular_ = sign_ == 0;
+  for (int i = 0; i < n && !singular_; i++) {
+    singular_ = std::fabs(lu_(i, i)) <= tolerance;
+  }
+}
+
+void S21LuFactorization::checkSolvable() const {
+  if (singular_) throw std::out_of_range("Error: determinant = 0");
+}
+
+void S21LuFactorization::checkRows(int rows) const {
+  if (rows != GetSize()) throw std::out_of_range("Error: Wrong matrix size");
+}
@@ -0,0 +1,56 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_LU_FACTORIZATION_H
+#define CPP1_S21_MATRIXPLUS_S21_LU_FACTORIZATION_H
+
+// LU factorization with partial pivoting, P A = L U, computed once and
+// reused. Solving against it costs 2 n^2 per right-hand side, where
+// InverseMatrix() followed by MulMatrix costs 2 n^3 up front and rounds
+// worse. Like InverseMatrix(), it treats a pivot whose magnitude does not
+// exceed n * machine epsilon * max|a_ij| as zero. Solving or inverting a
+// singular matrix throws std::out_of_range.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <vector>
+
+class S21LuFactorization {
+ public:
+  // constructors; throw std::invalid_argument for a non-square matrix
+  explicit S21LuFactorization(const S21Matrix& matrix);
+  // factors in the buffer of matrix
+  explicit S21LuFactorization(S21Matrix&& matrix);
+
+  // methods
+  // the solution X of A X = b for n x k b
+  S21Matrix Solve(const S21Matrix& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  // overwrite b with the solution, without allocating
+  void SolveInPlace(S21Matrix& b) const;
+  void SolveInPlace(std::vector<double>& b) const;
+  // caller-provided storage: n rows of cols elements, ld apart
+  void SolveInPlace(double* b, int cols, int ld) const;
+  double Determinant() const noexcept;
+  // see S21Matrix::LogDeterminant
+  double LogDeterminant(int& sign) const noexcept;
+  S21Matrix InverseMatrix() const;
+
+  // accessors
+  int GetSize() const noexcept { return lu_.GetRows(); }
+  bool IsSingular() const noexcept { return singular_; }
+  // L below the unit diagonal, U on and above it
+  const S21Matrix& Factors() const noexcept { return lu_; }
+  // row k of A was swapped with row Pivots()[k], in order
+  const std::vector<int>& Pivots() const noexcept { return pivots_; }
+
+ private:
+  S21Matrix lu_;
+  std::vector<int> pivots_;
+  // of the permutation; 0 when an exactly zero pivot stopped the
+  // factorization early
+  int sign_;
+  bool singular_;
+
+  void Factor();
+  void checkSolvable() const;
+  void checkRows(int rows) const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_LU_FACTORIZATION_H
@@ -0,0 +1,469 @@
+// Lane values are 64 bytes wide, which GCC would pass differently with and
+// without AVX-512. They never leave this file (the S21FixedMatrix
+// instantiations over them included), so the warning is moot.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+constexpr int kLanes = S21MatrixBatch::kLanes;
+
+// kLanes matrices side by side: lane l of every value belongs to matrix
+// b + l. GCC lowers the arithmetic to the widest vectors the target has.
+typedef double Lane __attribute__((vector_size(sizeof(double) * kLanes)));
+
+// lane groups per chunk when a batch is split across threads
+constexpr std::size_t kGroupGrain = 256;
+
+// N x N closed forms, shared with S21FixedMatrix
+template <int N>
+using LaneMatrix = S21FixedMatrix<N, N, Lane>;
+
+inline __attribute__((always_inline)) Lane LoadLane(const double* plane,
+                                                    std::size_t b) {
+  Lane v;
+  std::memcpy(&v, plane + b, sizeof(Lane));
+  return v;
+}
+
+inline __attribute__((always_inline)) void StoreLane(double* plane,
+                                                     std::size_t b,
+                                                     const Lane& v) {
+  std::memcpy(plane + b, &v, sizeof(Lane));
+}
+
+template <int N>
+inline __attribute__((always_inline)) LaneMatrix<N> LoadMatrices(
+    const double* a, std::size_t stride, std::size_t b) {
+  LaneMatrix<N> m;
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      m(i, j) = LoadLane(a + (i * N + j) * stride, b);
+    }
+  }
+  return m;
+}
+
+// Bodies over lane groups [begin, end), each compiled once per instruction
+// set below. Planes are padded to whole groups, so there is no tail.
+template <int N>
+inline __attribute__((always_inline)) void DeterminantBody(
+    const double* a, std::size_t stride, double* det, std::size_t begin,
+    std::size_t end) {
+  for (std::size_t g = begin; g < end; g++) {
+    const std::size_t b = g * kLanes;
+    StoreLane(det, b, LoadMatrices<N>(a, stride, b).Determinant());
+  }
+}
+
+// Same test as S21FixedMatrix::InverseMatrix, lane by lane: a determinant
+// within N * epsilon * max|a_ij|^N of zero marks the matrix singular, and
+// its inverse is written as zeros.
+template <int N>
+inline __attribute__((always_inline)) void InverseBody(
+    const double* a, std::size_t stride, double* inv, std::uint8_t* singular,
+    std::size_t begin, std::size_t end) {
+  const Lane zero = {};
+  for (std::size_t g = begin; g < end; g++) {
+    const std::size_t b = g * kLanes;
+    const LaneMatrix<N> m = LoadMatrices<N>(a, stride, b);
+    Lane largest = zero;
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        const Lane v = m(i, j) < zero ? -m(i, j) : m(i, j);
+        largest = v > largest ? v : largest;
+      }
+    }
+    Lane tolerance = zero + N * std::numeric_limits<double>::epsilon();
+    for (int i = 0; i < N; i++) tolerance *= largest;
+    const Lane det = m.Determinant();
+    const auto invertible = det > tolerance || -det > tolerance;
+    const Lane scale = invertible ? 1 / det : zero;
+    const LaneMatrix<N> adjugate = m.CalcComplements().Transpose();
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        StoreLane(inv + (i * N + j) * stride, b, adjugate(i, j) * scale);
+      }
+    }
+    for (int l = 0; l < kLanes; l++) singular[b + l] = invertible[l] == 0;
+  }
+}
+
+// c (n x m) = a (n x k) * b (k x m) for every matrix, any shape
+inline __attribute__((always_inline)) void MulBody(
+    const double* a, const double* b, double* c, std::size_t stride, int n,
+    int m, int k, std::size_t begin, std::size_t end) {
+  for (std::size_t g = begin; g < end; g++) {
+    const std::size_t lane = g * kLanes;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < m; j++) {
+        Lane sum = {};
+        for (int p = 0; p < k; p++) {
+          sum += LoadLane(a + (static_cast<std::size_t>(i) * k + p) * stride,
+                          lane) *
+                 LoadLane(b + (static_cast<std::size_t>(p) * m + j) * stride,
+                          lane);
+        }
+        StoreLane(c + (static_cast<std::size_t>(i) * m + j) * stride, lane,
+                  sum);
+      }
+    }
+  }
+}
+
+using DeterminantFn = void (*)(const double*, std::size_t, double*,
+                               std::size_t, std::size_t);
+using InverseFn = void (*)(const double*, std::size_t, double*, std::uint8_t*,
+                           std::size_t, std::size_t);
+using MulFn = void (*)(const double*, const double*, double*, std::size_t,
+                       int, int, int, std::size_t, std::size_t);
+
+template <int N>
+void DeterminantDefault(const double* a, std::size_t stride, double* det,
+                        std::size_t begin, std::size_t end) {
+  DeterminantBody<N>(a, stride, det, begin, end);
+}
+
+template <int N>
+__attribute__((target("avx2,fma"))) void DeterminantAvx2(
+    const double* a, std::size_t stride, double* det, std::size_t begin,
+    std::size_t end) {
+  DeterminantBody<N>(a, stride, det, begin, end);
+}
+
+template <int N>
+__attribute__((target("avx512f"))) void DeterminantAvx512(
+    const double* a, std::size_t stride, double* det, std::size_t begin,
+    std::size_t end) {
+  DeterminantBody<N>(a, stride, det, begin, end);
+}
+
+template <int N>
+void InverseDefault(const double* a, std::size_t stride, double* inv,
+                    std::uint8_t* singular, std::size_t begin,
+                    std::size_t end) {
+  InverseBody<N>(a, stride, inv, singular, begin, end);
+}
+
+template <int N>
+__attribute__((target("avx2,fma"))) void InverseAvx2(
+    const double* a, std::size_t stride, double* inv, std::uint8_t* singular,
+    std::size_t begin, std::size_t end) {
+  InverseBody<N>(a, stride, inv, singular, begin, end);
+}
+
+template <int N>
+__attribute__((target("avx512f"))) void InverseAvx512(
+    const double* a, std::size_t stride, double* inv, std::uint8_t* singular,
+    std::size_t begin, std::size_t end) {
+  InverseBody<N>(a, stride, inv, singular, begin, end);
+}
+
+void MulDefault(const double* a, const double* b, double* c,
+                std::size_t stride, int n, int m, int k, std::size_t begin,
+                std::size_t end) {
+  MulBody(a, b, c, stride, n, m, k, begin, end);
+}
+
+__attribute__((target("avx2,fma"))) void MulAvx2(
+    const double* a, const double* b, double* c, std::size_t stride, int n,
+    int m, int k, std::size_t begin, std::size_t end) {
+  MulBody(a, b, c, stride, n, m, k, begin, end);
+}
+
+__attribute__((target("avx512f"))) void MulAvx512(
+    const double* a, const double* b, double* c, std::size_t stride, int n,
+    int m, int k, std::size_t begin, std::size_t end) {
+  MulBody(a, b, c, stride, n, m, k, begin, end);
+}
+
+template <typename Fn>
+Fn Pick(Fn fallback, Fn avx2, Fn avx512) {
+  using s21::kernels::SimdLevel;
+  const SimdLevel level = s21::kernels::ActiveSimdLevel();
+  if (level >= SimdLevel::kAvx512) return avx512;
+  return level >= SimdLevel::kAvx2 ? avx2 : fallback;
+}
+
+template <int N>
+DeterminantFn DeterminantKernel() {
+  return Pick<DeterminantFn>(DeterminantDefault<N>, DeterminantAvx2<N>,
+                             DeterminantAvx512<N>);
+}
+
+template <int N>
+InverseFn InverseKernel() {
+  return Pick<InverseFn>(InverseDefault<N>, InverseAvx2<N>, InverseAvx512<N>);
+}
+
+// nullptr above 4x4, where the closed forms stop
+DeterminantFn DeterminantKernel(int n) {
+  switch (n) {
+    case 1:
+      return DeterminantKernel<1>();
+    case 2:
+      return DeterminantKernel<2>();
+    case 3:
+      return DeterminantKernel<3>();
+    case 4:
+      return DeterminantKernel<4>();
+  }
+  return nullptr;
+}
+
+InverseFn InverseKernel(int n) {
+  switch (n) {
+    case 1:
+      return InverseKernel<1>();
+    case 2:
+      return InverseKernel<2>();
+    case 3:
+      return InverseKernel<3>();
+    case 4:
+      return InverseKernel<4>();
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+// constructors
+S21MatrixBatch::S21MatrixBatch()
+    : count_(0),
+      rows_(0),
+      cols_(0),
+      stride_(0),
+      matrix_(nullptr),
+      allocator_(nullptr) {}
+
+S21MatrixBatch::S21MatrixBatch(int count, int rows, int cols) {
+  if (count < 0 || rows < 0 || cols < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  count_ = count;
+  rows_ = rows;
+  cols_ = cols;
+  Allocate();
+}
+
+S21MatrixBatch::S21MatrixBatch(const S21MatrixBatch& other)
+    : count_(other.count_), rows_(other.rows_), cols_(other.cols_) {
+  Allocate();
+  if (matrix_ != nullptr) {
+    std::memcpy(matrix_, other.matrix_, sizeof(double) * Elements());
+  }
+}
+
+S21MatrixBatch::S21MatrixBatch(S21MatrixBatch&& other) noexcept
+    : count_(other.count_),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      matrix_(other.matrix_),
+      allocator_(other.allocator_) {
+  other.count_ = 0;
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.stride_ = 0;
+  other.matrix_ = nullptr;
+}
+
+S21MatrixBatch::~S21MatrixBatch() { Release(); }
+
+// methods
+std::vector<double> S21MatrixBatch::Determinant() const {
+  checkSquare();
+  const int n = rows_;
+  std::vector<double> det(stride_);
+  const std::size_t groups = stride_ / kLanes;
+  const std::size_t flops = static_cast<std::size_t>(n) * n * n * stride_;
+  if (const DeterminantFn kernel = DeterminantKernel(n)) {
+    const double* a = matrix_;
+    const std::size_t stride = stride_;
+    double* out = det.data();
+    s21::kernels::ParallelFor(
+        groups, kGroupGrain, flops,
+        [=](std::size_t begin, std::size_t end) {
+          kernel(a, stride, out, begin, end);
+        });
+  } else {
+    s21::kernels::ParallelFor(
+        count_, kGroupGrain, flops, [&](std::size_t begin, std::size_t end) {
+          for (std::size_t b = begin; b < end; b++) {
+            det[b] = Get(static_cast<int>(b)).Determinant();
+          }
+        });
+  }
+  det.resize(count_);
+  return det;
+}
+
+S21MatrixBatch S21MatrixBatch::InverseMatrix(Mask& singular) const {
+  checkSquare();
+  const int n = rows_;
+  S21MatrixBatch result(count_, n, n);
+  singular.assign(stride_, 0);
+  const std::size_t groups = stride_ / kLanes;
+  const std::size_t flops = static_cast<std::size_t>(n) * n * n * stride_;
+  if (const InverseFn kernel = InverseKernel(n)) {
+    const double* a = matrix_;
+    const std::size_t stride = stride_;
+    double* inv = result.matrix_;
+    std::uint8_t* mask = singular.data();
+    s21::kernels::ParallelFor(
+        groups, kGroupGrain, flops, [=](std::size_t begin, std::size_t end) {
+          kernel(a, stride, inv, mask, begin, end);
+        });
+  } else {
+    s21::kernels::ParallelFor(
+        count_, kGroupGrain, flops, [&](std::size_t begin, std::size_t end) {
+          using namespace s21::kernels;
+          const std::size_t size = static_cast<std::size_t>(n) * n;
+          double* a = Scratch<double>(size, kScratchFactor);
+          int* pivots = Scratch<int>(n, kScratchPivots);
+          for (std::size_t b = begin; b < end; b++) {
+            for (std::size_t e = 0; e < size; e++) {
+              a[e] = matrix_[e * stride_ + b];
+            }
+            if (!InvertInPlace(a, n, n, pivots)) {
+              singular[b] = 1;
+              continue;
+            }
+            for (std::size_t e = 0; e < size; e++) {
+              result.matrix_[e * stride_ + b] = a[e];
+            }
+          }
+        });
+  }
+  singular.resize(count_);
+  return result;
+}
+
+void S21MatrixBatch::MulMatrix(const S21MatrixBatch& other) {
+  if (count_ != other.count_ || cols_ != other.rows_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  S21MatrixBatch result(count_, rows_, other.cols_);
+  const MulFn kernel = Pick<MulFn>(MulDefault, MulAvx2, MulAvx512);
+  const double* a = matrix_;
+  const double* b = other.matrix_;
+  double* c = result.matrix_;
+  const std::size_t stride = stride_;
+  const int n = rows_, m = other.cols_, k = cols_;
+  s21::kernels::ParallelFor(
+      stride_ / kLanes, kGroupGrain,
+      2 * static_cast<std::size_t>(n) * m * k * stride_,
+      [=](std::size_t begin, std::size_t end) {
+        kernel(a, b, c, stride, n, m, k, begin, end);
+      });
+  *this = std::move(result);
+}
+
+S21MatrixBatch S21MatrixBatch::Transpose() const {
+  S21MatrixBatch result(count_, cols_, rows_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      std::memcpy(result.Plane(j, i), Plane(i, j), sizeof(double) * count_);
+    }
+  }
+  return result;
+}
+
+// operators
+S21MatrixBatch& S21MatrixBatch::operator=(const S21MatrixBatch& other) {
+  if (this != &other) {
+    S21MatrixBatch copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator=(S21MatrixBatch&& other) noexcept {
+  if (this != &other) {
+    Release();
+    count_ = other.count_;
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    matrix_ = other.matrix_;
+    allocator_ = other.allocator_;
+    other.count_ = 0;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.matrix_ = nullptr;
+  }
+  return *this;
+}
+
+double& S21MatrixBatch::operator()(int index, int row, int col) const {
+  checkIndex(index);
+  if (cols_ <= col || rows_ <= row || row < 0 || col < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  return matrix_[(static_cast<std::size_t>(row) * cols_ + col) * stride_ +
+                 index];
+}
+
+// accessors
+S21Matrix S21MatrixBatch::Get(int index) const {
+  checkIndex(index);
+  S21Matrix matrix(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    double* row = matrix.RowData(i);
+    for (int j = 0; j < cols_; j++) row[j] = Plane(i, j)[index];
+  }
+  return matrix;
+}
+
+void S21MatrixBatch::Set(int index, const S21Matrix& matrix) {
+  checkIndex(index);
+  if (matrix.GetRows() != rows_ || matrix.GetCols() != cols_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  for (int i = 0; i < rows_; i++) {
+    const double* row = matrix.RowData(i);
+    for (int j = 0; j < cols_; j++) Plane(i, j)[index] = row[j];
+  }
+}
+
+// private methods
+void S21MatrixBatch::Allocate() {
+  stride_ = (static_cast<std::size_t>(count_) + kLanes - 1) / kLanes * kLanes;
+  matrix_ = nullptr;
+  allocator_ = &S21CurrentAllocator();
+  if (Elements() > 0) {
+    matrix_ = static_cast<double*>(
+        allocator_->Allocate(sizeof(double) * Elements()));
+    std::memset(matrix_, 0, sizeof(double) * Elements());
+  }
+}
+
+void S21MatrixBatch::Release() noexcept {
+  if (matrix_ != nullptr) {
+    allocator_->Deallocate(matrix_, sizeof(double) * Elements());
+    matrix_ = nullptr;
+  }
+}
+
+std::size_t S21MatrixBatch::Elements() const noexcept {
+  return static_cast<std::size_t>(rows_) * cols_ * stride_;
+}
+
+void S21MatrixBatch::checkIndex(int index) const {
+  if (index < 0 || index >= count_) {
+    throw std::out_of_range("Error: out of range");
+  }
+}
+
+void S21MatrixBatch::checkSquare() const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+}
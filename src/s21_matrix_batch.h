@@ -0,0 +1,78 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_BATCH_H
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_BATCH_H
+
+// GetCount() matrices of one shape, stored structure of arrays: element
+// (i, j) of every matrix forms one contiguous plane, so the batched
+// operations run the same closed form on a whole vector of matrices at a
+// time and split the batch over the thread pool. Meant for millions of
+// small (2x2 to 4x4) matrices; larger shapes work but go one matrix at a
+// time. A singular member does not throw: InverseMatrix reports it in a
+// mask and leaves zeros in its slot. Shape and count mismatches still throw
+// like S21Matrix does.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class S21MatrixBatch {
+ public:
+  // one entry per matrix, non-zero for the matrices without an inverse
+  using Mask = std::vector<std::uint8_t>;
+
+  // constructors
+  S21MatrixBatch();
+  ~S21MatrixBatch();
+  // count zero-filled rows x cols matrices
+  S21MatrixBatch(int count, int rows, int cols);
+  S21MatrixBatch(const S21MatrixBatch& other);
+  S21MatrixBatch(S21MatrixBatch&& other) noexcept;
+
+  // methods
+  // the determinant of every matrix
+  std::vector<double> Determinant() const;
+  S21MatrixBatch InverseMatrix(Mask& singular) const;
+  // replaces matrix b with matrix b times other's matrix b
+  void MulMatrix(const S21MatrixBatch& other);
+  S21MatrixBatch Transpose() const;
+
+  // operators
+  S21MatrixBatch& operator=(const S21MatrixBatch& other);
+  S21MatrixBatch& operator=(S21MatrixBatch&& other) noexcept;
+  // element (row, col) of matrix index
+  double& operator()(int index, int row, int col) const;
+
+  // accessors
+  int GetCount() const noexcept { return count_; }
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  // element (row, col) of matrices 0 .. GetCount() - 1, for bulk loading
+  // without a copy per matrix; no bounds check
+  double* Plane(int row, int col) noexcept {
+    return matrix_ + (static_cast<std::size_t>(row) * cols_ + col) * stride_;
+  }
+  const double* Plane(int row, int col) const noexcept {
+    return matrix_ + (static_cast<std::size_t>(row) * cols_ + col) * stride_;
+  }
+  // copies matrix index out of or into the batch
+  S21Matrix Get(int index) const;
+  void Set(int index, const S21Matrix& matrix);
+
+  // matrices per vector; planes are padded to a multiple of it
+  static constexpr int kLanes = 8;
+
+ private:
+  int count_, rows_, cols_;
+  // distance between planes, count_ rounded up to kLanes
+  std::size_t stride_;
+  double* matrix_;
+  S21MatrixAllocator* allocator_;
+
+  void Allocate();
+  void Release() noexcept;
+  std::size_t Elements() const noexcept;
+  void checkIndex(int index) const;
+  void checkSquare() const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_BATCH_H
@@ -0,0 +1,365 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_EXPR_H
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_EXPR_H
+
+// Lazy elementwise expressions. a + b - c * 2.0 builds a small tree of nodes
+// instead of matrices; assigning it into an S21Matrix evaluates every element
+// in one fused pass. Leaves refer to named matrices, so an expression must
+// not outlive them: store results in S21Matrix, not in auto.
+// An operand that is an expiring S21Matrix (std::move(a) + b, a * b + c) is
+// computed in place instead and the operator returns it as an S21Matrix.
+// A view operand (a + b.Transpose()) is copied into a matrix that the
+// expression owns, since the fused loop walks plain row-major storage.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <type_traits>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_matrix_view.h"
+
+template <typename E>
+class S21MatrixExpr {
+ public:
+  const E& Self() const noexcept { return static_cast<const E&>(*this); }
+
+  // the read-only part of the S21Matrix interface, so that the result of
+  // a + b can still be used like a matrix. Elements and comparisons are
+  // computed on the fly; the rest evaluates the expression once into a
+  // matrix and works on that.
+  double operator()(int row, int col) const;
+  bool EqMatrix(const S21Matrix& other) const;
+  S21Matrix Transpose() const;
+  S21Matrix CalcComplements() const;
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+};
+
+// M is const S21Matrix& for named operands, S21Matrix for temporaries
+// (e.g. the result of a product), which the leaf then owns.
+template <typename M>
+class S21MatrixLeaf : public S21MatrixExpr<S21MatrixLeaf<M>> {
+ public:
+  explicit S21MatrixLeaf(M m) : m_(std::forward<M>(m)) {}
+  int GetRows() const noexcept { return m_.GetRows(); }
+  int GetCols() const noexcept { return m_.GetCols(); }
+  int Stride() const noexcept { return m_.Stride(); }
+  double Coeff(std::size_t i) const noexcept { return m_.Data()[i]; }
+  // floating point operations per element
+  static constexpr int kFlops = 0;
+
+ private:
+  M m_;
+};
+
+struct S21AddOp {
+  static double Apply(double a, double b) noexcept { return a + b; }
+};
+
+struct S21SubOp {
+  static double Apply(double a, double b) noexcept { return a - b; }
+};
+
+template <typename L, typename R, typename Op>
+class S21MatrixBinary : public S21MatrixExpr<S21MatrixBinary<L, R, Op>> {
+ public:
+  S21MatrixBinary(L l, R r) : l_(std::move(l)), r_(std::move(r)) {
+    if (l_.GetRows() != r_.GetRows() || l_.GetCols() != r_.GetCols()) {
+      throw std::out_of_range("Error: Wrong matrix size");
+    }
+  }
+  int GetRows() const noexcept { return l_.GetRows(); }
+  int GetCols() const noexcept { return l_.GetCols(); }
+  int Stride() const noexcept { return l_.Stride(); }
+  double Coeff(std::size_t i) const noexcept {
+    return Op::Apply(l_.Coeff(i), r_.Coeff(i));
+  }
+  static constexpr int kFlops = L::kFlops + R::kFlops + 1;
+
+ private:
+  L l_;
+  R r_;
+};
+
+template <typename E>
+class S21MatrixScaled : public S21MatrixExpr<S21MatrixScaled<E>> {
+ public:
+  S21MatrixScaled(E e, double num) : e_(std::move(e)), num_(num) {}
+  int GetRows() const noexcept { return e_.GetRows(); }
+  int GetCols() const noexcept { return e_.GetCols(); }
+  int Stride() const noexcept { return e_.Stride(); }
+  double Coeff(std::size_t i) const noexcept { return e_.Coeff(i) * num_; }
+  static constexpr int kFlops = E::kFlops + 1;
+
+ private:
+  E e_;
+  double num_;
+};
+
+namespace s21::expr {
+
+template <typename T>
+struct IsExpr
+    : std::is_base_of<S21MatrixExpr<std::decay_t<T>>, std::decay_t<T>> {};
+
+// an S21Matrix passed as an rvalue: its buffer can hold the result
+template <typename T>
+constexpr bool kIsTemporary = std::is_same_v<T, S21Matrix>;
+
+template <typename T>
+constexpr bool kIsView = std::is_same_v<std::decay_t<T>, S21MatrixView>;
+
+template <typename T>
+constexpr bool kIsOperand = std::is_same_v<std::decay_t<T>, S21Matrix> ||
+                            kIsView<T> || IsExpr<T>::value;
+
+inline S21MatrixLeaf<const S21Matrix&> MakeNode(const S21Matrix& m) {
+  return S21MatrixLeaf<const S21Matrix&>(m);
+}
+
+inline S21MatrixLeaf<S21Matrix> MakeNode(S21Matrix&& m) {
+  return S21MatrixLeaf<S21Matrix>(std::move(m));
+}
+
+inline S21MatrixLeaf<S21Matrix> MakeNode(const S21MatrixView& v) {
+  return S21MatrixLeaf<S21Matrix>(S21Matrix(v));
+}
+
+template <typename E, typename = std::enable_if_t<IsExpr<E>::value>>
+std::decay_t<E> MakeNode(E&& e) {
+  return std::forward<E>(e);
+}
+
+template <typename T>
+using Node = decltype(MakeNode(std::declval<T>()));
+
+// Runs out[i] = fn(out[i], e.Coeff(i)) over the whole padded buffer of a
+// matrix shaped like e, split over the thread pool when it is large.
+// kCombineFlops is what fn itself costs per element.
+template <int kCombineFlops, typename E, typename Fn>
+void Evaluate(double* out, const E& e, Fn fn) {
+  s21::kernels::TimedOperation timed(S21Instrumentation::kExpression);
+  s21::kernels::CountFlops(
+      S21Instrumentation::kElementwise,
+      static_cast<std::size_t>(e.GetRows()) * e.GetCols() *
+          (E::kFlops + kCombineFlops));
+  const std::size_t count = static_cast<std::size_t>(e.GetRows()) * e.Stride();
+  s21::kernels::ParallelFor(count, 1 << 14, count,
+                            [out, &e, fn](std::size_t begin, std::size_t end) {
+                              for (std::size_t i = begin; i < end; i++) {
+                                out[i] = fn(out[i], e.Coeff(i));
+                              }
+                            });
+}
+
+template <typename E>
+bool Near(const E& e, const S21Matrix& m) {
+  if (e.GetRows() != m.GetRows() || e.GetCols() != m.GetCols()) return false;
+  const double eps = S21MatrixTraits<double>::kEpsilon;
+  for (int i = 0; i < m.GetRows(); i++) {
+    const std::size_t row = static_cast<std::size_t>(i) * m.Stride();
+    for (int j = 0; j < m.GetCols(); j++) {
+      if (fabs(e.Coeff(row + j) - m.Data()[row + j]) > eps) return false;
+    }
+  }
+  return true;
+}
+
+// operands of a product are needed as real matrices for the GEMM kernel
+inline const S21Matrix& Materialize(const S21Matrix& m, S21Matrix&) {
+  return m;
+}
+
+template <typename E>
+const S21Matrix& Materialize(const S21MatrixExpr<E>& e, S21Matrix& storage) {
+  storage = S21Matrix(e);
+  return storage;
+}
+
+// with a view among the operands the product goes through the strided
+// GEMM instead, so that the view is not copied
+inline S21MatrixView AsView(const S21MatrixView& v, S21Matrix&) { return v; }
+
+template <typename T>
+S21MatrixView AsView(const T& operand, S21Matrix& storage) {
+  return S21MatrixView(Materialize(operand, storage));
+}
+
+}  // namespace s21::expr
+
+template <typename E>
+double S21MatrixExpr<E>::operator()(int row, int col) const {
+  const E& e = Self();
+  if (e.GetCols() <= col || e.GetRows() <= row || row < 0 || col < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  return e.Coeff(static_cast<std::size_t>(row) * e.Stride() + col);
+}
+
+template <typename E>
+bool S21MatrixExpr<E>::EqMatrix(const S21Matrix& other) const {
+  return s21::expr::Near(Self(), other);
+}
+
+template <typename E>
+S21Matrix S21MatrixExpr<E>::Transpose() const {
+  return S21Matrix(Self()).Transpose();
+}
+
+template <typename E>
+S21Matrix S21MatrixExpr<E>::CalcComplements() const {
+  return S21Matrix(Self()).CalcComplements();
+}
+
+template <typename E>
+double S21MatrixExpr<E>::Determinant() const {
+  return S21Matrix(Self()).Determinant();
+}
+
+template <typename E>
+S21Matrix S21MatrixExpr<E>::InverseMatrix() const {
+  return S21Matrix(Self()).InverseMatrix();
+}
+
+template <typename E>
+S21Matrix::S21BasicMatrix(const S21MatrixExpr<E>& expr)
+    : rows_(expr.Self().GetRows()), cols_(expr.Self().GetCols()) {
+  Allocate();
+  s21::expr::Evaluate<0>(matrix_, expr.Self(),
+                         [](double, double v) { return v; });
+}
+
+template <typename E>
+S21Matrix& S21Matrix::operator=(const S21MatrixExpr<E>& expr) {
+  const E& e = expr.Self();
+  if (e.GetRows() != rows_ || e.GetCols() != cols_) {
+    // a differently shaped result cannot have *this among its operands
+    if (static_cast<std::size_t>(e.GetRows()) * e.Stride() > capacity_) {
+      S21Matrix result(expr);
+      return *this = std::move(result);
+    }
+    rows_ = e.GetRows();
+    cols_ = e.GetCols();
+    stride_ = e.Stride();
+  }
+  // every element only depends on the same element of the operands, so
+  // writing over an operand while evaluating is safe
+  s21::expr::Evaluate<0>(matrix_, e, [](double, double v) { return v; });
+  return *this;
+}
+
+template <typename E>
+S21Matrix& S21Matrix::operator+=(const S21MatrixExpr<E>& expr) {
+  checkSize(expr.Self().GetRows(), expr.Self().GetCols());
+  s21::expr::Evaluate<1>(matrix_, expr.Self(),
+                         [](double a, double v) { return a + v; });
+  return *this;
+}
+
+template <typename E>
+S21Matrix& S21Matrix::operator-=(const S21MatrixExpr<E>& expr) {
+  checkSize(expr.Self().GetRows(), expr.Self().GetCols());
+  s21::expr::Evaluate<1>(matrix_, expr.Self(),
+                         [](double a, double v) { return a - v; });
+  return *this;
+}
+
+inline s21::expr::Sum S21Matrix::operator+(const S21Matrix& other) const {
+  return s21::expr::Sum(s21::expr::Ref(*this), s21::expr::Ref(other));
+}
+
+inline s21::expr::Difference S21Matrix::operator-(
+    const S21Matrix& other) const {
+  return s21::expr::Difference(s21::expr::Ref(*this), s21::expr::Ref(other));
+}
+
+inline s21::expr::Scaled S21Matrix::operator*(const double num) const {
+  return s21::expr::Scaled(s21::expr::Ref(*this), num);
+}
+
+inline s21::expr::Scaled operator*(const double num, const S21Matrix& m) {
+  return m * num;
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<s21::expr::kIsOperand<L> &&
+                                      s21::expr::kIsOperand<R>>>
+auto operator+(L&& l, R&& r) {
+  using namespace s21::expr;
+  if constexpr (kIsTemporary<L>) {
+    l += r;
+    return S21Matrix(std::move(l));
+  } else if constexpr (kIsTemporary<R>) {
+    r += l;
+    return S21Matrix(std::move(r));
+  } else {
+    return S21MatrixBinary<Node<L>, Node<R>, S21AddOp>(
+        MakeNode(std::forward<L>(l)), MakeNode(std::forward<R>(r)));
+  }
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<s21::expr::kIsOperand<L> &&
+                                      s21::expr::kIsOperand<R>>>
+auto operator-(L&& l, R&& r) {
+  using namespace s21::expr;
+  if constexpr (kIsTemporary<L>) {
+    l -= r;
+    return S21Matrix(std::move(l));
+  } else if constexpr (kIsTemporary<R>) {
+    r = std::forward<L>(l) - r;
+    return S21Matrix(std::move(r));
+  } else {
+    return S21MatrixBinary<Node<L>, Node<R>, S21SubOp>(
+        MakeNode(std::forward<L>(l)), MakeNode(std::forward<R>(r)));
+  }
+}
+
+template <typename E, typename = std::enable_if_t<s21::expr::kIsOperand<E>>>
+auto operator*(E&& e, const double num) {
+  using namespace s21::expr;
+  if constexpr (kIsTemporary<E>) {
+    e *= num;
+    return S21Matrix(std::move(e));
+  } else {
+    return S21MatrixScaled<Node<E>>(MakeNode(std::forward<E>(e)), num);
+  }
+}
+
+template <typename E, typename = std::enable_if_t<s21::expr::kIsOperand<E>>>
+auto operator*(const double num, E&& e) {
+  return std::forward<E>(e) * num;
+}
+
+// the matrix product is never fused: it goes to the GEMM kernel and its
+// result becomes a leaf of the surrounding expression
+template <typename L, typename R,
+          typename = std::enable_if_t<s21::expr::kIsOperand<L> &&
+                                      s21::expr::kIsOperand<R>>>
+S21Matrix operator*(const L& l, const R& r) {
+  using namespace s21::expr;
+  S21Matrix left, right;
+  if constexpr (kIsView<L> || kIsView<R>) {
+    return AsView(l, left).MulMatrix(AsView(r, right));
+  } else {
+    return Materialize(l, left) * Materialize(r, right);
+  }
+}
+
+template <typename E, typename = std::enable_if_t<s21::expr::IsExpr<E>::value>>
+bool operator==(const E& e, const S21Matrix& m) {
+  return s21::expr::Near(e, m);
+}
+
+template <typename E, typename = std::enable_if_t<s21::expr::IsExpr<E>::value>>
+bool operator==(const S21Matrix& m, const E& e) {
+  return s21::expr::Near(e, m);
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<s21::expr::IsExpr<L>::value &&
+                                      s21::expr::IsExpr<R>::value>>
+bool operator==(const L& l, const R& r) {
+  return s21::expr::Near(l, S21Matrix(r));
+}
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_EXPR_H
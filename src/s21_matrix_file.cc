@@ -0,0 +1,268 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+
+static_assert(sizeof(S21MatrixFile::Header) == 64,
+              "the header is one cache line on disk");
+
+// Allocator of the matrices Load() returns: their buffer is part of a
+// mapping, and giving it back unmaps the file. Mappings enter through
+// Allocate() like any other buffer, so Stats() stays balanced.
+class MappedFileAllocator : public S21MatrixAllocator {
+ public:
+  double* Adopt(void* base, std::size_t length, double* data,
+                std::size_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      mappings_[data] = {base, length};
+    }
+    adopting = data;
+    return static_cast<double*>(Allocate(bytes));
+  }
+
+ protected:
+  void* DoAllocate(std::size_t) override {
+    void* ptr = adopting;
+    adopting = nullptr;
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+  }
+
+  void DoDeallocate(void* ptr, std::size_t) noexcept override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = mappings_.find(ptr);
+    if (it != mappings_.end()) {
+      ::munmap(it->second.base, it->second.length);
+      mappings_.erase(it);
+    }
+  }
+
+ private:
+  struct Mapping {
+    void* base;
+    std::size_t length;
+  };
+
+  // the buffer the next Allocate() on this thread hands out
+  static thread_local void* adopting;
+
+  std::mutex mutex_;
+  std::unordered_map<const void*, Mapping> mappings_;
+};
+
+thread_local void* MappedFileAllocator::adopting = nullptr;
+
+MappedFileAllocator& MappedFiles() {
+  static MappedFileAllocator allocator;
+  return allocator;
+}
+
+std::size_t ElementSize(S21MatrixFile::DType dtype) {
+  using DType = S21MatrixFile::DType;
+  switch (dtype) {
+    case DType::kFloat64:
+    case DType::kInt64:
+      return 8;
+    case DType::kFloat32:
+      return 4;
+    case DType::kComplex128:
+      return 16;
+  }
+  return 0;
+}
+
+// bytes the header promises, from the start of the file to the last
+// element; 0 when the header is not one this version can read
+unsigned __int128 RequiredBytes(const S21MatrixFile::Header& h) {
+  using Layout = S21MatrixFile::Layout;
+  const std::size_t element = ElementSize(h.dtype);
+  if (std::memcmp(h.magic, S21MatrixFile::kMagic, sizeof(h.magic)) != 0 ||
+      h.version == 0 || h.version > S21MatrixFile::kVersion ||
+      h.byte_order != S21MatrixFile::kByteOrder || element == 0 ||
+      (h.layout != Layout::kRowMajor && h.layout != Layout::kColMajor) ||
+      h.rows > INT_MAX || h.cols > INT_MAX ||
+      h.data_offset < sizeof(S21MatrixFile::Header) ||
+      h.data_offset % element != 0) {
+    return 0;
+  }
+  const bool row_major = h.layout == Layout::kRowMajor;
+  const std::uint64_t majors = row_major ? h.rows : h.cols;
+  const std::uint64_t minors = row_major ? h.cols : h.rows;
+  if (h.stride < minors) return 0;
+  unsigned __int128 elements = 0;
+  if (majors > 0 && minors > 0) {
+    elements = static_cast<unsigned __int128>(majors - 1) * h.stride + minors;
+  }
+  return h.data_offset + elements * element;
+}
+
+bool WriteAll(int fd, const void* data, std::size_t bytes) {
+  const char* from = static_cast<const char*>(data);
+  while (bytes > 0) {
+    const ssize_t written = ::write(fd, from, bytes);
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) return false;
+    from += written;
+    bytes -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+}  // namespace
+
+S21MatrixFile::S21MatrixFile(const std::string& path)
+    : header_(), base_(nullptr), length_(0) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) throw std::runtime_error("Error: cannot open " + path);
+  struct stat info;
+  if (::fstat(fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+    ::close(fd);
+    throw std::runtime_error("Error: not a matrix file: " + path);
+  }
+  length_ = static_cast<std::size_t>(info.st_size);
+  // private, so that Load() can make the pages copy-on-write
+  base_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base_ == MAP_FAILED) {
+    base_ = nullptr;
+    throw std::runtime_error("Error: cannot map " + path);
+  }
+  std::memcpy(&header_, base_, sizeof(Header));
+  const unsigned __int128 required = RequiredBytes(header_);
+  if (required == 0 || required > length_) {
+    Unmap();
+    throw std::runtime_error("Error: not a matrix file: " + path);
+  }
+}
+
+S21MatrixFile::~S21MatrixFile() { Unmap(); }
+
+S21MatrixFile::S21MatrixFile(S21MatrixFile&& other) noexcept
+    : header_(other.header_), base_(other.base_), length_(other.length_) {
+  other.base_ = nullptr;
+  other.length_ = 0;
+}
+
+S21MatrixFile& S21MatrixFile::operator=(S21MatrixFile&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    header_ = other.header_;
+    base_ = other.base_;
+    length_ = other.length_;
+    other.base_ = nullptr;
+    other.length_ = 0;
+  }
+  return *this;
+}
+
+S21MatrixFile::Header S21MatrixFile::MakeHeader(int rows, int cols,
+                                                std::uint64_t stride) {
+  Header header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.dtype = DType::kFloat64;
+  header.layout = Layout::kRowMajor;
+  header.alignment = S21Matrix::kAlignment;
+  header.rows = rows;
+  header.cols = cols;
+  header.stride = stride;
+  header.data_offset = S21Matrix::kAlignment;
+  header.byte_order = kByteOrder;
+  return header;
+}
+
+void S21MatrixFile::Save(const std::string& path, const S21Matrix& matrix) {
+  static std::atomic<unsigned> saves{0};
+  const Header header =
+      MakeHeader(matrix.GetRows(), matrix.GetCols(), matrix.Stride());
+  // matrix may be a mapping of path itself (Load, edit, Save), so the old
+  // file has to stay intact until the new one is complete: write next to
+  // it and rename over it
+  const std::string temporary = path + ".tmp" + std::to_string(::getpid()) +
+                                "." + std::to_string(saves++);
+  const int fd =
+      ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  if (fd < 0) throw std::runtime_error("Error: cannot write " + path);
+  const std::size_t bytes = sizeof(double) *
+                            static_cast<std::size_t>(matrix.GetRows()) *
+                            matrix.Stride();
+  bool written = WriteAll(fd, &header, sizeof(header)) &&
+                 WriteAll(fd, matrix.Data(), bytes);
+  written = ::close(fd) == 0 && written;
+  if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+    ::unlink(temporary.c_str());
+    throw std::runtime_error("Error: cannot write " + path);
+  }
+}
+
+S21Matrix S21MatrixFile::Load(const std::string& path) {
+  S21MatrixFile file(path);
+  const Header& h = file.header_;
+  const int rows = file.GetRows(), cols = file.GetCols();
+  const std::size_t elements = static_cast<std::size_t>(rows) *
+                               S21Matrix::PaddedStride(cols);
+  // S21Matrix runs its kernels over the row padding too, so the mapping
+  // has to cover every padded row, the last one included
+  const bool adoptable =
+      h.dtype == DType::kFloat64 && h.layout == Layout::kRowMajor &&
+      h.stride == static_cast<std::uint64_t>(S21Matrix::PaddedStride(cols)) &&
+      h.data_offset % S21Matrix::kAlignment == 0 && elements > 0 &&
+      h.data_offset + sizeof(double) * elements <= file.length_;
+  if (!adoptable) return S21Matrix(file.View());
+  // the matrix is writable, so its stores go to copy-on-write pages
+  if (::mprotect(file.base_, file.length_, PROT_READ | PROT_WRITE) != 0) {
+    throw std::runtime_error("Error: cannot map " + path);
+  }
+  S21Matrix matrix;
+  matrix.rows_ = rows;
+  matrix.cols_ = cols;
+  matrix.stride_ = static_cast<int>(h.stride);
+  matrix.capacity_ = elements;
+  matrix.matrix_ = MappedFiles().Adopt(file.base_, file.length_,
+                                       file.Elements(),
+                                       sizeof(double) * elements);
+  matrix.allocator_ = &MappedFiles();
+  file.base_ = nullptr;
+  return matrix;
+}
+
+S21MatrixView S21MatrixFile::View() const {
+  if (header_.dtype != DType::kFloat64) {
+    throw std::runtime_error("Error: the file does not hold float64 data");
+  }
+  const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(header_.stride);
+  if (header_.layout == Layout::kColMajor) {
+    return S21MatrixView(Elements(), GetRows(), GetCols(), 1, stride)
+        .ReadOnly();
+  }
+  return S21MatrixView(Elements(), GetRows(), GetCols(), stride, 1)
+      .ReadOnly();
+}
+
+double* S21MatrixFile::Elements() const noexcept {
+  return reinterpret_cast<double*>(static_cast<char*>(base_) +
+                                   header_.data_offset);
+}
+
+void S21MatrixFile::Unmap() noexcept {
+  if (base_ != nullptr) {
+    ::munmap(base_, length_);
+    base_ = nullptr;
+  }
+  length_ = 0;
+}
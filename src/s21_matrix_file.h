@@ -0,0 +1,86 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_FILE_H
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_FILE_H
+
+// Binary matrix files: a 64-byte header (magic, version, element type,
+// layout, alignment, shape, row stride and data offset) followed by the
+// raw elements. Save() writes the padded S21Matrix buffer as is, so Load()
+// can map the file and hand the mapping to an S21Matrix without copying or
+// parsing anything; pages are read on first touch. S21MatrixFile maps the
+// file read-only and View() is a read-only view. Load() returns an ordinary
+// S21Matrix, which can be modified, so its pages are copy-on-write
+// instead: writes stay in memory and never reach the file. I/O errors and
+// malformed files throw std::runtime_error.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class S21MatrixFile {
+ public:
+  enum class DType : std::uint32_t {
+    kFloat64 = 1,
+    kFloat32 = 2,
+    kInt64 = 3,
+    kComplex128 = 4
+  };
+  enum class Layout : std::uint32_t { kRowMajor = 1, kColMajor = 2 };
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    DType dtype;
+    Layout layout;
+    // of the data offset and of every row, in bytes
+    std::uint32_t alignment;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    // elements between consecutive rows (columns for kColMajor)
+    std::uint64_t stride;
+    // bytes from the start of the file to the first element
+    std::uint64_t data_offset;
+    // kByteOrder as the writing machine stored it
+    std::uint32_t byte_order;
+    std::uint32_t reserved;
+  };
+
+  static constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrder = 0x01020304;
+
+  // maps the file at path
+  explicit S21MatrixFile(const std::string& path);
+  ~S21MatrixFile();
+  S21MatrixFile(S21MatrixFile&& other) noexcept;
+  S21MatrixFile& operator=(S21MatrixFile&& other) noexcept;
+  S21MatrixFile(const S21MatrixFile&) = delete;
+  S21MatrixFile& operator=(const S21MatrixFile&) = delete;
+
+  // header of a row-major float64 file whose data starts one alignment
+  // unit in, as Save() writes it
+  static Header MakeHeader(int rows, int cols, std::uint64_t stride);
+  // writes the header, then the storage of matrix, to a new file that
+  // replaces path once complete; matrix may be loaded from path
+  static void Save(const std::string& path, const S21Matrix& matrix);
+  // a matrix backed by the mapped file when its stride and alignment match
+  // what S21Matrix would allocate (true for anything Save() wrote), a copy
+  // otherwise
+  static S21Matrix Load(const std::string& path);
+
+  const Header& GetHeader() const noexcept { return header_; }
+  int GetRows() const noexcept { return static_cast<int>(header_.rows); }
+  int GetCols() const noexcept { return static_cast<int>(header_.cols); }
+  // the mapped float64 elements as a read-only view, valid while this
+  // object lives; a kColMajor file comes out as a transposed view
+  S21MatrixView View() const;
+
+ private:
+  Header header_;
+  void* base_;
+  std::size_t length_;
+
+  double* Elements() const noexcept;
+  void Unmap() noexcept;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_FILE_H
@@ -1,173 +1,296 @@
 #include "s21_matrix_oop.h"
 
-// constructors
-S21Matrix::S21Matrix() : rows_(0), cols_(0), matrix_(nullptr) {}
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "s21_kernels.h"
+
+namespace {
+
+// elements per chunk when elementwise kernels are split across threads
+constexpr std::size_t kElementGrain = 1 << 14;
 
-S21Matrix::S21Matrix(int rows, int cols) {
+}  // namespace
+
+// constructors
+S21Matrix::S21BasicMatrix()
+    : rows_(0),
+      cols_(0),
+      stride_(0),
+      capacity_(0),
+      matrix_(nullptr),
+      allocator_(nullptr) {}
+
+S21Matrix::S21BasicMatrix(int rows, int cols) {
   if (rows < 0 || cols < 0) throw std::out_of_range("Error: out of range");
   rows_ = rows;
   cols_ = cols;
   Allocate();
 }
 
-S21Matrix::S21Matrix(const S21Matrix& other)
+S21Matrix::S21BasicMatrix(const S21Matrix& other)
     : rows_(other.rows_), cols_(other.cols_), matrix_(nullptr) {
+  s21::kernels::TimedOperation timed(S21Instrumentation::kCopy);
+  s21::kernels::CountCopies(static_cast<std::size_t>(rows_) * cols_);
   Allocate();
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = other.matrix_[i][j];
+  if (matrix_ != nullptr) {
+    std::memcpy(matrix_, other.matrix_,
+                sizeof(double) * static_cast<std::size_t>(rows_) * stride_);
+  }
+}
+
+S21Matrix::S21BasicMatrix(const S21MatrixView& view)
+    : rows_(view.GetRows()), cols_(view.GetCols()) {
+  Allocate();
+  if (view.RowsContiguous()) {
+    for (int i = 0; i < rows_ && cols_ > 0; i++) {
+      std::memcpy(RowData(i), view.At(i, 0), sizeof(double) * cols_);
     }
+  } else if (view.RowStride() == 1 && view.Strideable()) {
+    // a transposed dense matrix: source rows [begin, end) become our
+    // columns [begin, end)
+    const auto transpose = s21::kernels::Elementwise().transpose;
+    const double* a = view.data_;
+    double* b = matrix_;
+    const int lda = static_cast<int>(view.ColStride()), ldb = stride_;
+    const int rows = cols_, cols = rows_;
+    const int block = 32;
+    s21::kernels::ParallelFor(
+        (rows + block - 1) / block, 1, Elements(),
+        [=](std::size_t begin, std::size_t end) {
+          const int i0 = static_cast<int>(begin) * block;
+          const int i1 = std::min(rows, static_cast<int>(end) * block);
+          transpose(a + static_cast<std::size_t>(i0) * lda, lda, b + i0, ldb,
+                    i1 - i0, cols);
+        });
+  } else {
+    // Allocate() zeroed the storage, so adding the view copies it tile by tile
+    S21MatrixView(*this).SumMatrix(view);
   }
 }
 
-S21Matrix::S21Matrix(S21Matrix&& other) noexcept
-    : rows_(other.rows_), cols_(other.cols_), matrix_(other.matrix_) {
+S21Matrix::S21BasicMatrix(S21Matrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      capacity_(other.capacity_),
+      matrix_(other.matrix_),
+      allocator_(other.allocator_) {
   other.cols_ = 0;
   other.rows_ = 0;
+  other.stride_ = 0;
+  other.capacity_ = 0;
   other.matrix_ = nullptr;
 }
 
-S21Matrix::~S21Matrix() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; i++) delete[] matrix_[i];
-    delete[] matrix_;
-    matrix_ = nullptr;
-  }
+S21Matrix::~S21BasicMatrix() {
+  Release();
   rows_ = 0;
   cols_ = 0;
+  stride_ = 0;
 }
 
 // public methods
 bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
     return false;
-  } else {
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        if (fabs(matrix_[i][j] - other.matrix_[i][j]) > EPS) {
-          return false;
-        }
-      }
-    }
   }
-  return true;
+  const auto near = s21::kernels::Elementwise().near;
+  const double* a = matrix_;
+  const double* b = other.matrix_;
+  const double eps = S21MatrixTraits<double>::kEpsilon;
+  std::atomic<bool> equal(true);
+  s21::kernels::ParallelFor(
+      Elements(), kElementGrain, Elements(),
+      [&, a, b](std::size_t begin, std::size_t end) {
+        if (equal.load(std::memory_order_relaxed) &&
+            !near(a + begin, b + begin, end - begin, eps)) {
+          equal.store(false, std::memory_order_relaxed);
+        }
+      });
+  return equal.load();
 }
 
 void S21Matrix::SumMatrix(const S21Matrix& other) {
   checkSize(other);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] += other.matrix_[i][j];
-    }
-  }
+  s21::kernels::TimedOperation timed(S21Instrumentation::kSumMatrix);
+  s21::kernels::CountFlops(S21Instrumentation::kElementwise,
+                           static_cast<std::size_t>(rows_) * cols_);
+  const auto add = s21::kernels::Elementwise().add;
+  double* a = matrix_;
+  const double* b = other.matrix_;
+  s21::kernels::ParallelFor(Elements(), kElementGrain, Elements(),
+                            [=](std::size_t begin, std::size_t end) {
+                              add(a + begin, b + begin, end - begin);
+                            });
 }
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
   checkSize(other);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] -= other.matrix_[i][j];
-    }
-  }
+  s21::kernels::TimedOperation timed(S21Instrumentation::kSubMatrix);
+  s21::kernels::CountFlops(S21Instrumentation::kElementwise,
+                           static_cast<std::size_t>(rows_) * cols_);
+  const auto sub = s21::kernels::Elementwise().sub;
+  double* a = matrix_;
+  const double* b = other.matrix_;
+  s21::kernels::ParallelFor(Elements(), kElementGrain, Elements(),
+                            [=](std::size_t begin, std::size_t end) {
+                              sub(a + begin, b + begin, end - begin);
+                            });
 }
 
 void S21Matrix::MulNumber(const double num) const noexcept {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] *= num;
-    }
-  }
+  s21::kernels::TimedOperation timed(S21Instrumentation::kMulNumber);
+  s21::kernels::CountFlops(S21Instrumentation::kElementwise,
+                           static_cast<std::size_t>(rows_) * cols_);
+  const auto scale = s21::kernels::Elementwise().scale;
+  double* a = matrix_;
+  s21::kernels::ParallelFor(Elements(), kElementGrain, Elements(),
+                            [=](std::size_t begin, std::size_t end) {
+                              scale(a + begin, num, end - begin);
+                            });
 }
 
 void S21Matrix::MulMatrix(const S21Matrix& other) {
   if (cols_ != other.rows_) {
     throw std::out_of_range("Error: Wrong matrix size");
   }
-  S21Matrix res(rows_, other.cols_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      for (int k = 0; k < cols_; k++) {
-        res.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
-      }
-    }
+  using namespace s21::kernels;
+  TimedOperation timed(S21Instrumentation::kMulMatrix);
+  if (UseStrassen(other)) {
+    *this = StrassenProduct(other);
+    return;
+  }
+  if (other.cols_ != cols_ || &other == this) {
+    S21Matrix res(rows_, other.cols_);
+    Gemm(rows_, other.cols_, cols_, matrix_, stride_, other.matrix_,
+         other.stride_, res.matrix_, res.stride_, false);
+    *this = std::move(res);
+    return;
+  }
+  // the shape is kept: each block of rows only feeds the same rows of the
+  // product, so it is copied aside and the product written over it
+  const int block = 64;
+  double* rows =
+      Scratch<double>(static_cast<std::size_t>(block) * stride_, kScratchRows);
+  for (int i = 0; i < rows_; i += block) {
+    const int count = std::min(block, rows_ - i);
+    std::memcpy(rows, RowData(i),
+                sizeof(double) * static_cast<std::size_t>(count) * stride_);
+    Gemm(count, cols_, cols_, rows, stride_, other.matrix_, other.stride_,
+         RowData(i), stride_, false);
   }
-  *this = res;
 }
 
-S21Matrix S21Matrix::Transpose() const noexcept {
-  S21Matrix result = S21Matrix(cols_, rows_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      result.matrix_[j][i] = matrix_[i][j];
-    }
+bool S21Matrix::EqMatrix(const S21MatrixView& other) const noexcept {
+  return S21MatrixView(*this).EqMatrix(other);
+}
+
+void S21Matrix::SumMatrix(const S21MatrixView& other) {
+  checkSize(other.GetRows(), other.GetCols());
+  S21MatrixView(*this).SumMatrix(other);
+}
+
+void S21Matrix::SubMatrix(const S21MatrixView& other) {
+  checkSize(other.GetRows(), other.GetCols());
+  S21MatrixView(*this).SubMatrix(other);
+}
+
+void S21Matrix::MulMatrix(const S21MatrixView& other) {
+  // the view may look into *this, so the product never overwrites it early
+  *this = S21MatrixView(*this).MulMatrix(other);
+}
+
+S21MatrixView S21Matrix::Transpose() const& noexcept {
+  return S21MatrixView(*this).Transpose();
+}
+
+S21Matrix S21Matrix::Transpose() && {
+  TransposeInPlace();
+  return std::move(*this);
+}
+
+void S21Matrix::TransposeInPlace() {
+  s21::kernels::TimedOperation timed(S21Instrumentation::kTranspose);
+  if (rows_ != cols_) {
+    S21Matrix transposed(S21MatrixView(*this).Transpose());
+    *this = std::move(transposed);
+    return;
   }
-  return result;
+  s21::kernels::TransposeInPlace(matrix_, rows_, stride_);
 }
 
 double S21Matrix::Determinant() const {
-  checkSquare();
-  double res = 0;
-  if (rows_ == 1) {
-    res = matrix_[0][0];
-  } else if (rows_ == 2) {
-    res = matrix_[0][0] * matrix_[1][1] - matrix_[0][1] * matrix_[1][0];
-  } else {
-    S21Matrix temp(rows_ - 1, cols_ - 1);
-    for (int i = 0; i < cols_; i++) {
-      for (int j = 0; j < temp.rows_; j++) {
-        for (int k = 0; k < i; k++) {
-          temp.matrix_[j][k] = matrix_[j + 1][k];
-        }
-        for (int k = i; k < temp.cols_; k++) {
-          temp.matrix_[j][k] = matrix_[j + 1][k + 1];
-        }
-      }
-      res += matrix_[0][i] * pow(-1, i) * temp.Determinant();
-    }
-  }
-  return res;
+  s21::kernels::TimedOperation timed(S21Instrumentation::kDeterminant);
+  return S21MatrixView(*this).Determinant();
+}
+
+double S21Matrix::LogDeterminant(int& sign) const {
+  s21::kernels::TimedOperation timed(S21Instrumentation::kDeterminant);
+  return S21MatrixView(*this).LogDeterminant(sign);
 }
 
 S21Matrix S21Matrix::CalcComplements() const {
   checkSquare();
+  s21::kernels::TimedOperation timed(S21Instrumentation::kCalcComplements);
   S21Matrix result(rows_, cols_);
+  const S21MatrixView whole(*this);
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
-      double det = GetMinor(i, j).Determinant();
-      result.matrix_[i][j] = det * pow(-1, i + j);
+      double det = whole.Minor(i, j).Determinant();
+      result(i, j) = det * pow(-1, i + j);
     }
   }
   return result;
 }
 
 S21Matrix S21Matrix::InverseMatrix() const {
-  double det = Determinant();
-  if (det == 0 || rows_ != cols_) {
+  checkSquare();
+  s21::kernels::TimedOperation timed(S21Instrumentation::kInverseMatrix);
+  S21Matrix res(*this);
+  int* pivots = s21::kernels::Scratch<int>(rows_, s21::kernels::kScratchPivots);
+  if (!s21::kernels::InvertInPlace(res.matrix_, rows_, res.stride_, pivots)) {
     throw std::out_of_range("Error: determinant = 0");
   }
-  S21Matrix res = S21Matrix(rows_, cols_);
-  if (rows_ == 1) {
-    res.matrix_[0][0] = 1 / matrix_[0][0];
-  } else {
-    res = CalcComplements().Transpose();
-    res.MulNumber(1 / det);
-  }
   return res;
 }
 
 // operators
 S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
-  if (!EqMatrix(other)) {
-    this->~S21Matrix();
-    new (this) S21Matrix(other);
+  if (this != &other) {
+    if (other.Elements() > capacity_) {
+      S21Matrix copy(other);
+      return *this = std::move(copy);
+    }
+    s21::kernels::TimedOperation timed(S21Instrumentation::kCopy);
+    s21::kernels::CountCopies(static_cast<std::size_t>(other.rows_) *
+                              other.cols_);
+    // the current buffer is large enough: keep it
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    if (Elements() > 0) {
+      std::memcpy(matrix_, other.matrix_, sizeof(double) * Elements());
+    }
   }
   return *this;
 }
 
 S21Matrix& S21Matrix::operator=(S21Matrix&& other) noexcept {
-  if (!EqMatrix(other)) {
-    this->~S21Matrix();
-    new (this) S21Matrix(std::move(other));
+  if (this != &other) {
+    Release();
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    capacity_ = other.capacity_;
+    matrix_ = other.matrix_;
+    allocator_ = other.allocator_;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.capacity_ = 0;
+    other.matrix_ = nullptr;
   }
   return *this;
 }
@@ -176,7 +299,7 @@ double& S21Matrix::operator()(int row, int col) const {
   if (cols_ <= col || rows_ <= row || row < 0 || col < 0) {
     throw std::out_of_range("Error: out of range");
   }
-  return matrix_[row][col];
+  return matrix_[static_cast<std::size_t>(row) * stride_ + col];
 }
 
 S21Matrix& S21Matrix::operator*=(const double other) {
@@ -199,35 +322,34 @@ S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
   return *this;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix& other) const {
-  S21Matrix result = *this;
-  return result += other;
-}
-
-S21Matrix S21Matrix::operator-(const S21Matrix& other) const {
-  S21Matrix result = *this;
-  return result -= other;
+bool S21Matrix::operator==(const S21Matrix& other) const noexcept {
+  return EqMatrix(other);
 }
 
-bool S21Matrix::operator==(const S21Matrix& other) noexcept {
+bool S21Matrix::operator==(const S21MatrixView& other) const noexcept {
   return EqMatrix(other);
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix& other) const {
-  S21Matrix result(*this);
-  result.MulMatrix(other);
-  return result;
+S21Matrix S21Matrix::operator*(const S21Matrix& other) && {
+  MulMatrix(other);
+  return std::move(*this);
 }
 
-S21Matrix S21Matrix::operator*(const double num) const {
-  S21Matrix result(*this);
-  result.MulNumber(num);
+S21Matrix S21Matrix::operator*(const S21Matrix& other) const& {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  s21::kernels::TimedOperation timed(S21Instrumentation::kMulMatrix);
+  if (UseStrassen(other)) return StrassenProduct(other);
+  S21Matrix result(rows_, other.cols_);
+  s21::kernels::Gemm(rows_, other.cols_, cols_, matrix_, stride_,
+                     other.matrix_, other.stride_, result.matrix_,
+                     result.stride_, false);
   return result;
 }
 
-S21Matrix operator*(const double num, const S21Matrix& other) {
-  S21Matrix result = other;
-  return result *= num;
+S21Matrix S21Matrix::operator*(const S21MatrixView& other) const {
+  return S21MatrixView(*this).MulMatrix(other);
 }
 
 // accessors
@@ -235,55 +357,152 @@ int S21Matrix::GetCols() const noexcept { return cols_; }
 
 int S21Matrix::GetRows() const noexcept { return rows_; }
 
+int S21Matrix::Stride() const noexcept { return stride_; }
+
+double* S21Matrix::Data() noexcept { return matrix_; }
+
+const double* S21Matrix::Data() const noexcept { return matrix_; }
+
+double* S21Matrix::RowData(int row) noexcept {
+  return matrix_ + static_cast<std::size_t>(row) * stride_;
+}
+
+const double* S21Matrix::RowData(int row) const noexcept {
+  return matrix_ + static_cast<std::size_t>(row) * stride_;
+}
+
+S21MatrixView S21Matrix::Block(int row, int col, int rows, int cols) {
+  return S21MatrixView(*this).Block(row, col, rows, cols);
+}
+
+S21MatrixView S21Matrix::Block(int row, int col, int rows, int cols) const {
+  return S21MatrixView(*this).Block(row, col, rows, cols);
+}
+
+S21MatrixView S21Matrix::Row(int row) {
+  return S21MatrixView(*this).Row(row);
+}
+
+S21MatrixView S21Matrix::Row(int row) const {
+  return S21MatrixView(*this).Row(row);
+}
+
+S21MatrixView S21Matrix::Col(int col) {
+  return S21MatrixView(*this).Col(col);
+}
+
+S21MatrixView S21Matrix::Col(int col) const {
+  return S21MatrixView(*this).Col(col);
+}
+
+S21MatrixView S21Matrix::Minor(int row, int col) {
+  return S21MatrixView(*this).Minor(row, col);
+}
+
+S21MatrixView S21Matrix::Minor(int row, int col) const {
+  return S21MatrixView(*this).Minor(row, col);
+}
+
 // mutators
 void S21Matrix::SetCols(const int value) {
   if (value < 0) throw std::out_of_range("Error: invalid size of matrix");
-  if (value != cols_) {
+  if (value == cols_) return;
+  const int stride = PaddedStride(value);
+  const int kept = (value > cols_) ? cols_ : value;
+  if (static_cast<std::size_t>(rows_) * stride > capacity_) {
     S21Matrix newMatrix(rows_, value);
-    int newCols = (value > cols_) ? cols_ : value;
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < newCols; j++) {
-        newMatrix.matrix_[i][j] = matrix_[i][j];
-      }
+    for (int i = 0; i < rows_ && kept > 0; i++) {
+      std::memcpy(newMatrix.RowData(i), RowData(i), sizeof(double) * kept);
+    }
+    *this = std::move(newMatrix);
+    return;
+  }
+  // repack the rows inside the current buffer; walking towards the rows
+  // that are already consumed keeps every move from overwriting unread data
+  for (int n = 0; n < rows_; n++) {
+    const int i = (stride > stride_) ? rows_ - 1 - n : n;
+    double* to = matrix_ + static_cast<std::size_t>(i) * stride;
+    if (stride != stride_ && kept > 0) {
+      std::memmove(to, RowData(i), sizeof(double) * kept);
     }
-    *this = newMatrix;
+    // new columns and the padding start zeroed: the elementwise kernels
+    // and EqMatrix run over whole rows of stride elements
+    std::memset(to + kept, 0, sizeof(double) * (stride - kept));
   }
+  cols_ = value;
+  stride_ = stride;
 }
 
 void S21Matrix::SetRows(const int value) {
   if (value < 0) throw std::out_of_range("Error: invalid size of matrix");
-  if (value != rows_) {
+  if (value == rows_) return;
+  if (static_cast<std::size_t>(value) * stride_ > capacity_) {
     S21Matrix newMatrix(value, cols_);
-    int newRows = (value > rows_) ? rows_ : value;
-    for (int i = 0; i < newRows; i++) {
-      for (int j = 0; j < cols_; j++) {
-        newMatrix.matrix_[i][j] = matrix_[i][j];
-      }
+    if (rows_ > 0 && stride_ > 0) {
+      std::memcpy(newMatrix.matrix_, matrix_, sizeof(double) * Elements());
     }
-    *this = newMatrix;
+    *this = std::move(newMatrix);
+    return;
   }
+  if (value > rows_) {
+    std::memset(RowData(rows_), 0,
+                sizeof(double) * static_cast<std::size_t>(value - rows_) *
+                    stride_);
+  }
+  rows_ = value;
 }
 
 // private methods
 void S21Matrix::Allocate() {
-  matrix_ = new double*[rows_]();
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_]();
+  stride_ = PaddedStride(cols_);
+  std::size_t count = static_cast<std::size_t>(rows_) * stride_;
+  capacity_ = count;
+  matrix_ = nullptr;
+  allocator_ = &S21CurrentAllocator();
+  if (count > 0) {
+    matrix_ =
+        static_cast<double*>(allocator_->Allocate(sizeof(double) * count));
+    std::memset(matrix_, 0, sizeof(double) * count);
   }
 }
 
-S21Matrix S21Matrix::GetMinor(int row, int col) const {
-  int row_skip = 0;
-  S21Matrix minor(cols_ - 1, rows_ - 1);
-  for (int i = 0; i < rows_ - 1; i++) {
-    int column_skip = 0;
-    if (i == row) row_skip = 1;
-    for (int j = 0; j < cols_ - 1; j++) {
-      if (j == col) column_skip = 1;
-      minor.matrix_[i][j] = matrix_[i + row_skip][j + column_skip];
-    }
+void S21Matrix::Release() noexcept {
+  if (matrix_ != nullptr) {
+    allocator_->Deallocate(matrix_, sizeof(double) * capacity_);
+    matrix_ = nullptr;
   }
-  return minor;
+  capacity_ = 0;
+}
+
+std::size_t S21Matrix::Elements() const noexcept {
+  return static_cast<std::size_t>(rows_) * stride_;
+}
+
+int S21Matrix::PaddedStride(int cols) noexcept {
+  const int per_line = static_cast<int>(kAlignment / sizeof(double));
+  return (cols + per_line - 1) / per_line * per_line;
+}
+
+bool S21Matrix::UseStrassen(const S21Matrix& other) const noexcept {
+  const int threshold = S21Strassen::GetThreshold();
+  return threshold > 0 && rows_ >= threshold && rows_ == cols_ &&
+         other.rows_ == rows_ && other.cols_ == rows_ &&
+         rows_ > S21Strassen::GetCrossover();
+}
+
+S21Matrix S21Matrix::StrassenProduct(const S21Matrix& other) const {
+  using namespace s21::kernels;
+  const int crossover = S21Strassen::GetCrossover();
+  S21Matrix result(rows_, cols_);
+  // every recursion level carves its temporaries out of this one buffer
+  const std::size_t bytes =
+      sizeof(double) * StrassenWorkspace(rows_, crossover);
+  S21MatrixAllocator& allocator = S21CurrentAllocator();
+  double* workspace = static_cast<double*>(allocator.Allocate(bytes));
+  StrassenGemm(rows_, matrix_, stride_, other.matrix_, other.stride_,
+               result.matrix_, result.stride_, crossover, workspace);
+  allocator.Deallocate(workspace, bytes);
+  return result;
 }
 
 void S21Matrix::checkSquare() const {
@@ -293,7 +512,11 @@ void S21Matrix::checkSquare() const {
 }
 
 void S21Matrix::checkSize(const S21Matrix& other) const {
-  if (other.GetCols() != cols_ || other.GetRows() != rows_) {
+  checkSize(other.rows_, other.cols_);
+}
+
+void S21Matrix::checkSize(int rows, int cols) const {
+  if (cols != cols_ || rows != rows_) {
     throw std::out_of_range("Error: Wrong matrix size");
   }
 }
@@ -2,18 +2,58 @@
 #define CPP1_S21_MATRIXPLUS_S21_MATRIX_OOP_H
 
 #include <cmath>
+#include <cstddef>
 #include <stdexcept>
 
-#define EPS 1e-7
+#include "s21_allocator.h"
+#include "s21_instrumentation.h"
+#include "s21_matrix_traits.h"
+#include "s21_parallel.h"
+#include "s21_strassen.h"
 
-class S21Matrix {
+template <typename E>
+class S21MatrixExpr;
+template <typename M>
+class S21MatrixLeaf;
+template <typename L, typename R, typename Op>
+class S21MatrixBinary;
+template <typename E>
+class S21MatrixScaled;
+struct S21AddOp;
+struct S21SubOp;
+class S21MatrixView;
+
+// Matrix of T elements. The double case below is specialized with the SIMD,
+// threaded and lazy machinery; other element types use the generic template
+// in s21_basic_matrix.h.
+template <typename T>
+class S21BasicMatrix;
+
+using S21Matrix = S21BasicMatrix<double>;
+
+// the expressions built by the member operators below
+namespace s21::expr {
+using Ref = S21MatrixLeaf<const S21Matrix&>;
+using Sum = S21MatrixBinary<Ref, Ref, S21AddOp>;
+using Difference = S21MatrixBinary<Ref, Ref, S21SubOp>;
+using Scaled = S21MatrixScaled<Ref>;
+}  // namespace s21::expr
+
+template <>
+class S21BasicMatrix<double> {
  public:
   // constructors
-  S21Matrix();
-  ~S21Matrix();
-  explicit S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other) noexcept;
+  S21BasicMatrix();
+  ~S21BasicMatrix();
+  explicit S21BasicMatrix(int rows, int cols);
+  S21BasicMatrix(const S21Matrix& other);
+  S21BasicMatrix(S21Matrix&& other) noexcept;
+  // evaluates a lazy expression such as a + b * 2.0 in a single pass
+  template <typename E>
+  S21BasicMatrix(const S21MatrixExpr<E>& expr);
+  // copies the viewed elements into a matrix of their own, so that
+  // S21Matrix t = a.Transpose() materializes the transposed view
+  S21BasicMatrix(const S21MatrixView& view);
 
   // methods
   bool EqMatrix(const S21Matrix& other) const noexcept;
@@ -21,41 +61,117 @@ class S21Matrix {
   void SubMatrix(const S21Matrix& other);
   void MulNumber(const double num) const noexcept;
   void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose() const noexcept;
+  bool EqMatrix(const S21MatrixView& other) const noexcept;
+  void SumMatrix(const S21MatrixView& other);
+  void SubMatrix(const S21MatrixView& other);
+  void MulMatrix(const S21MatrixView& other);
+  // lazy: a read-only view of the same storage with the strides swapped,
+  // which GEMM, the elementwise operations and comparisons read directly.
+  // An expiring matrix is transposed in its own buffer instead.
+  S21MatrixView Transpose() const& noexcept;
+  S21Matrix Transpose() &&;
+  // square matrices are transposed in place without allocating
+  void TransposeInPlace();
   S21Matrix CalcComplements() const;
   double Determinant() const;
+  // log|det| with the sign of det stored in sign (-1, 0 or 1); stays finite
+  // where Determinant() would overflow. Returns -HUGE_VAL for singular input.
+  double LogDeterminant(int& sign) const;
   S21Matrix InverseMatrix() const;
 
   // operators
   S21Matrix& operator=(const S21Matrix& other);
   S21Matrix& operator=(S21Matrix&& other) noexcept;
+  template <typename E>
+  S21Matrix& operator=(const S21MatrixExpr<E>& expr);
   double& operator()(int row, int col) const;
   S21Matrix& operator*=(const double other);
   S21Matrix& operator*=(const S21Matrix& other);
   S21Matrix& operator+=(const S21Matrix& other);
   S21Matrix& operator-=(const S21Matrix& other);
-  S21Matrix operator+(const S21Matrix& other) const;
-  S21Matrix operator-(const S21Matrix& other) const;
-  bool operator==(const S21Matrix& other) noexcept;
-  S21Matrix operator*(const S21Matrix& other) const;
-  S21Matrix operator*(const double num) const;
-  friend S21Matrix operator*(const double num, const S21Matrix& other);
+  template <typename E>
+  S21Matrix& operator+=(const S21MatrixExpr<E>& expr);
+  template <typename E>
+  S21Matrix& operator-=(const S21MatrixExpr<E>& expr);
+  bool operator==(const S21Matrix& other) const noexcept;
+  bool operator==(const S21MatrixView& other) const noexcept;
+  S21Matrix operator*(const S21Matrix& other) const&;
+  // reuses the storage of an expiring left operand when the shape allows
+  S21Matrix operator*(const S21Matrix& other) &&;
+  S21Matrix operator*(const S21MatrixView& other) const;
+  // +, - and multiplication by a number are lazy, see s21_matrix_expr.h;
+  // the free operators there also take temporaries and expressions
+  s21::expr::Sum operator+(const S21Matrix& other) const;
+  s21::expr::Difference operator-(const S21Matrix& other) const;
+  s21::expr::Scaled operator*(const double num) const;
+  friend s21::expr::Scaled operator*(const double num, const S21Matrix& m);
 
   // accesors
   int GetRows() const noexcept;
   int GetCols() const noexcept;
+  // raw storage: rows are Stride() elements apart, each row starts on a
+  // kAlignment-byte boundary, padding past GetCols() is not part of the matrix
+  int Stride() const noexcept;
+  double* Data() noexcept;
+  const double* Data() const noexcept;
+  double* RowData(int row) noexcept;
+  const double* RowData(int row) const noexcept;
+  // zero-copy views into this matrix, see s21_matrix_view.h; read-only
+  // when the matrix is const
+  S21MatrixView Block(int row, int col, int rows, int cols);
+  S21MatrixView Block(int row, int col, int rows, int cols) const;
+  S21MatrixView Row(int row);
+  S21MatrixView Row(int row) const;
+  S21MatrixView Col(int col);
+  S21MatrixView Col(int col) const;
+  S21MatrixView Minor(int row, int col);
+  S21MatrixView Minor(int row, int col) const;
   // mutators
   void SetRows(int value);
   void SetCols(int value);
 
+  static constexpr std::size_t kAlignment = 64;
+
  private:
+  // adopts mapped files as storage
+  friend class S21MatrixFile;
+
   int rows_, cols_;
-  double** matrix_;
+  int stride_;
+  // allocated elements; assignment and resizing reuse the buffer while the
+  // new rows_ * stride_ fits
+  std::size_t capacity_;
+  double* matrix_;
+  // where matrix_ came from and goes back to
+  S21MatrixAllocator* allocator_;
 
   void Allocate();
-  S21Matrix GetMinor(int i, int j) const;
+  void Release() noexcept;
+  // element count of the buffer; padding is never read back as matrix data,
+  // so elementwise kernels run over it as one contiguous range
+  std::size_t Elements() const noexcept;
+  static int PaddedStride(int cols) noexcept;
+  // true when this * other should take the Strassen-Winograd path
+  bool UseStrassen(const S21Matrix& other) const noexcept;
+  S21Matrix StrassenProduct(const S21Matrix& other) const;
   void checkSquare() const;
   void checkSize(const S21Matrix& other) const;
+  void checkSize(int rows, int cols) const;
 };
 
+#include "s21_async.h"
+#include "s21_basic_matrix.h"
+#include "s21_cholesky_factorization.h"
+#include "s21_fixed_matrix.h"
+#include "s21_inverse_tracker.h"
+#include "s21_lu_factorization.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_expr.h"
+#include "s21_matrix_file.h"
+#include "s21_matrix_view.h"
+#include "s21_mixed_precision.h"
+#include "s21_out_of_core.h"
+#include "s21_qr_factorization.h"
+#include "s21_sparse_matrix.h"
+
 #endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_OOP_H
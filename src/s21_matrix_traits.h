@@ -0,0 +1,50 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_TRAITS_H
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_TRAITS_H
+
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+
+// Per element type constants of S21BasicMatrix. Real is the type of
+// Magnitude(), kEpsilon the largest element difference EqMatrix and ==
+// still treat as equal, and kExact marks types whose arithmetic never
+// rounds, so that Determinant() can stay fraction-free.
+template <typename T>
+struct S21MatrixTraits;
+
+template <>
+struct S21MatrixTraits<double> {
+  using Real = double;
+  static constexpr Real kEpsilon = 1e-7;
+  static constexpr bool kExact = false;
+  static Real Magnitude(double v) noexcept { return std::abs(v); }
+};
+
+template <>
+struct S21MatrixTraits<float> {
+  using Real = float;
+  // float keeps about 7 significant digits, so 1e-7 would demand equality
+  static constexpr Real kEpsilon = 1e-4f;
+  static constexpr bool kExact = false;
+  static Real Magnitude(float v) noexcept { return std::abs(v); }
+};
+
+template <>
+struct S21MatrixTraits<std::int64_t> {
+  using Real = std::int64_t;
+  static constexpr Real kEpsilon = 0;
+  static constexpr bool kExact = true;
+  static Real Magnitude(std::int64_t v) noexcept { return std::abs(v); }
+};
+
+template <typename R>
+struct S21MatrixTraits<std::complex<R>> {
+  using Real = R;
+  static constexpr Real kEpsilon = S21MatrixTraits<R>::kEpsilon;
+  static constexpr bool kExact = false;
+  static Real Magnitude(const std::complex<R>& v) noexcept {
+    return std::abs(v);
+  }
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_TRAITS_H
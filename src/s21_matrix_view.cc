@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// Side of the squares strided views are walked in, so that a transposed
+// operand is read a few cache lines at a time rather than one per element.
+constexpr int kTile = 32;
+
+// Calls fn(i, j) for rows [row_begin, row_end) and every column, tile by
+// tile; stops early when fn returns false.
+template <typename Fn>
+bool ForEachTiled(int row_begin, int row_end, int cols, Fn fn) {
+  for (int ib = row_begin; ib < row_end; ib += kTile) {
+    const int ie = std::min(ib + kTile, row_end);
+    for (int jb = 0; jb < cols; jb += kTile) {
+      const int je = std::min(jb + kTile, cols);
+      for (int i = ib; i < ie; i++) {
+        for (int j = jb; j < je; j++) {
+          if (!fn(i, j)) return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// constructors
+S21MatrixView::S21MatrixView(S21Matrix& matrix) noexcept
+    : data_(matrix.Data()),
+      rows_(matrix.GetRows()),
+      cols_(matrix.GetCols()),
+      row_stride_(matrix.Stride()),
+      col_stride_(1),
+      skip_row_(kNoSkip),
+      skip_col_(kNoSkip),
+      writable_(true) {}
+
+S21MatrixView::S21MatrixView(const S21Matrix& matrix) noexcept
+    : S21MatrixView(const_cast<S21Matrix&>(matrix)) {
+  writable_ = false;
+}
+
+S21MatrixView::S21MatrixView(double* data, int rows, int cols,
+                             std::ptrdiff_t row_stride,
+                             std::ptrdiff_t col_stride)
+    : data_(data),
+      rows_(rows),
+      cols_(cols),
+      row_stride_(row_stride),
+      col_stride_(col_stride),
+      skip_row_(kNoSkip),
+      skip_col_(kNoSkip),
+      writable_(true) {
+  if (rows < 0 || cols < 0) throw std::out_of_range("Error: out of range");
+}
+
+double& S21MatrixView::operator()(int row, int col) const {
+  if (cols_ <= col || rows_ <= row || row < 0 || col < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  return *At(row, col);
+}
+
+// sub-views
+S21MatrixView S21MatrixView::Block(int row, int col, int rows,
+                                   int cols) const {
+  if (row < 0 || col < 0 || rows < 0 || cols < 0 || row + rows > rows_ ||
+      col + cols > cols_) {
+    throw std::out_of_range("Error: out of range");
+  }
+  S21MatrixView block(*this);
+  block.data_ = At(row, col);
+  block.rows_ = rows;
+  block.cols_ = cols;
+  // At() already stepped over a skipped line that lies before the block
+  if (skip_row_ != kNoSkip) {
+    block.skip_row_ = skip_row_ > row ? skip_row_ - row : kNoSkip;
+  }
+  if (skip_col_ != kNoSkip) {
+    block.skip_col_ = skip_col_ > col ? skip_col_ - col : kNoSkip;
+  }
+  return block;
+}
+
+S21MatrixView S21MatrixView::Row(int row) const {
+  return Block(row, 0, 1, cols_);
+}
+
+S21MatrixView S21MatrixView::Col(int col) const {
+  return Block(0, col, rows_, 1);
+}
+
+S21MatrixView S21MatrixView::Minor(int row, int col) const {
+  if (cols_ <= col || rows_ <= row || row < 0 || col < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  if (!Strideable()) {
+    throw std::invalid_argument("Error: the view already skips a line");
+  }
+  S21MatrixView minor(*this);
+  minor.rows_ = rows_ - 1;
+  minor.cols_ = cols_ - 1;
+  minor.skip_row_ = row;
+  minor.skip_col_ = col;
+  return minor;
+}
+
+S21MatrixView S21MatrixView::Transpose() const noexcept {
+  S21MatrixView transposed(*this);
+  std::swap(transposed.rows_, transposed.cols_);
+  std::swap(transposed.row_stride_, transposed.col_stride_);
+  std::swap(transposed.skip_row_, transposed.skip_col_);
+  return transposed;
+}
+
+S21MatrixView S21MatrixView::ReadOnly() const noexcept {
+  S21MatrixView view(*this);
+  view.writable_ = false;
+  return view;
+}
+
+// methods
+bool S21MatrixView::EqMatrix(const S21MatrixView& other) const noexcept {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  const auto near = s21::kernels::Elementwise().near;
+  const double eps = S21MatrixTraits<double>::kEpsilon;
+  if (!RowsContiguous() || !other.RowsContiguous()) {
+    return ForEachTiled(0, rows_, cols_, [&](int i, int j) {
+      return fabs(*At(i, j) - *other.At(i, j)) <= eps;
+    });
+  }
+  for (int i = 0; i < rows_; i++) {
+    if (!near(At(i, 0), other.At(i, 0), cols_, eps)) return false;
+  }
+  return true;
+}
+
+void S21MatrixView::SumMatrix(const S21MatrixView& other) const {
+  checkWritable();
+  checkSize(other);
+  if (Aliases(other)) {
+    SumMatrix(S21Matrix(other));
+    return;
+  }
+  const auto add = s21::kernels::Elementwise().add;
+  const bool rows_contiguous = RowsContiguous() && other.RowsContiguous();
+  const S21MatrixView self = *this;
+  s21::kernels::ParallelFor(
+      rows_, 64, static_cast<std::size_t>(rows_) * cols_,
+      [&, add, rows_contiguous](std::size_t begin, std::size_t end) {
+        const int i0 = static_cast<int>(begin), i1 = static_cast<int>(end);
+        if (rows_contiguous) {
+          for (int i = i0; i < i1; i++) {
+            add(self.At(i, 0), other.At(i, 0), self.cols_);
+          }
+          return;
+        }
+        ForEachTiled(i0, i1, self.cols_, [&](int i, int j) {
+          *self.At(i, j) += *other.At(i, j);
+          return true;
+        });
+      });
+}
+
+void S21MatrixView::SubMatrix(const S21MatrixView& other) const {
+  checkWritable();
+  checkSize(other);
+  if (Aliases(other)) {
+    SubMatrix(S21Matrix(other));
+    return;
+  }
+  const auto sub = s21::kernels::Elementwise().sub;
+  const bool rows_contiguous = RowsContiguous() && other.RowsContiguous();
+  const S21MatrixView self = *this;
+  s21::kernels::ParallelFor(
+      rows_, 64, static_cast<std::size_t>(rows_) * cols_,
+      [&, sub, rows_contiguous](std::size_t begin, std::size_t end) {
+        const int i0 = static_cast<int>(begin), i1 = static_cast<int>(end);
+        if (rows_contiguous) {
+          for (int i = i0; i < i1; i++) {
+            sub(self.At(i, 0), other.At(i, 0), self.cols_);
+          }
+          return;
+        }
+        ForEachTiled(i0, i1, self.cols_, [&](int i, int j) {
+          *self.At(i, j) -= *other.At(i, j);
+          return true;
+        });
+      });
+}
+
+void S21MatrixView::MulNumber(const double num) const {
+  checkWritable();
+  const auto scale = s21::kernels::Elementwise().scale;
+  if (!RowsContiguous()) {
+    ForEachTiled(0, rows_, cols_, [&](int i, int j) {
+      *At(i, j) *= num;
+      return true;
+    });
+    return;
+  }
+  for (int i = 0; i < rows_; i++) scale(At(i, 0), num, cols_);
+}
+
+S21Matrix S21MatrixView::MulMatrix(const S21MatrixView& other) const {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  // minors are gathered into plain matrices first
+  S21Matrix left, right;
+  s21::kernels::Strided a = AsStrided(), b = other.AsStrided();
+  if (!Strideable()) {
+    left = S21Matrix(*this);
+    a = {left.Data(), left.Stride(), 1};
+  }
+  if (!other.Strideable()) {
+    right = S21Matrix(other);
+    b = {right.Data(), right.Stride(), 1};
+  }
+  S21Matrix result(rows_, other.cols_);
+  s21::kernels::Gemm(rows_, other.cols_, cols_, a, b, result.Data(),
+                     result.Stride(), false);
+  return result;
+}
+
+double S21MatrixView::Determinant() const {
+  checkSquare();
+  double res = 1;
+  if (rows_ == 1) {
+    res = *At(0, 0);
+  } else if (rows_ == 2) {
+    res = *At(0, 0) * *At(1, 1) - *At(0, 1) * *At(1, 0);
+  } else if (rows_ == 3) {
+    res = *At(0, 0) * (*At(1, 1) * *At(2, 2) - *At(1, 2) * *At(2, 1)) -
+          *At(0, 1) * (*At(1, 0) * *At(2, 2) - *At(1, 2) * *At(2, 0)) +
+          *At(0, 2) * (*At(1, 0) * *At(2, 1) - *At(1, 1) * *At(2, 0));
+  } else if (rows_ > 3) {
+    const double* lu = nullptr;
+    res = FactorToScratch(&lu);
+    for (int i = 0; i < rows_ && res != 0; i++) {
+      res *= lu[static_cast<std::size_t>(i) * rows_ + i];
+    }
+  }
+  return res;
+}
+
+double S21MatrixView::LogDeterminant(int& sign) const {
+  checkSquare();
+  const double* lu = nullptr;
+  sign = FactorToScratch(&lu);
+  double res = 0;
+  for (int i = 0; i < rows_ && sign != 0; i++) {
+    double pivot = lu[static_cast<std::size_t>(i) * rows_ + i];
+    if (pivot < 0) sign = -sign;
+    res += std::log(std::fabs(pivot));
+  }
+  return sign == 0 ? -HUGE_VAL : res;
+}
+
+S21Matrix S21MatrixView::InverseMatrix() const {
+  checkSquare();
+  S21Matrix res(*this);
+  int* pivots = s21::kernels::Scratch<int>(rows_, s21::kernels::kScratchPivots);
+  if (!s21::kernels::InvertInPlace(res.Data(), rows_, res.Stride(), pivots)) {
+    throw std::out_of_range("Error: determinant = 0");
+  }
+  return res;
+}
+
+S21Matrix operator*(const S21MatrixView& left, const S21MatrixView& right) {
+  return left.MulMatrix(right);
+}
+
+bool operator==(const S21MatrixView& left, const S21MatrixView& right) {
+  return left.EqMatrix(right);
+}
+
+// private methods
+bool S21MatrixView::Aliases(const S21MatrixView& other) const noexcept {
+  if (rows_ == 0 || cols_ == 0) return false;
+  if (data_ == other.data_ && row_stride_ == other.row_stride_ &&
+      col_stride_ == other.col_stride_ && skip_row_ == other.skip_row_ &&
+      skip_col_ == other.skip_col_) {
+    return false;
+  }
+  // the spans of the two views, a skipped line included
+  auto last = [](const S21MatrixView& v) {
+    const std::ptrdiff_t rows = v.rows_ - (v.skip_row_ == kNoSkip);
+    const std::ptrdiff_t cols = v.cols_ - (v.skip_col_ == kNoSkip);
+    return v.data_ + rows * v.row_stride_ + cols * v.col_stride_;
+  };
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data_);
+  const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(last(*this));
+  const std::uintptr_t other_begin =
+      reinterpret_cast<std::uintptr_t>(other.data_);
+  const std::uintptr_t other_end =
+      reinterpret_cast<std::uintptr_t>(last(other));
+  return begin <= other_end && other_begin <= end;
+}
+
+void S21MatrixView::checkSize(const S21MatrixView& other) const {
+  if (other.rows_ != rows_ || other.cols_ != cols_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+}
+
+void S21MatrixView::checkSquare() const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+}
+
+void S21MatrixView::checkWritable() const {
+  if (!writable_) throw std::logic_error("Error: the view is read-only");
+}
+
+int S21MatrixView::FactorToScratch(const double** lu) const {
+  using namespace s21::kernels;
+  const int n = rows_;
+  double* a = Scratch<double>(static_cast<std::size_t>(n) * n, kScratchFactor);
+  int* pivots = Scratch<int>(n, kScratchPivots);
+  if (RowsContiguous()) {
+    for (int i = 0; i < n; i++) {
+      std::memcpy(a + static_cast<std::size_t>(i) * n, At(i, 0),
+                  sizeof(double) * n);
+    }
+  } else {
+    ForEachTiled(0, n, n, [&](int i, int j) {
+      a[static_cast<std::size_t>(i) * n + j] = *At(i, j);
+      return true;
+    });
+  }
+  *lu = a;
+  return LuFactor(a, n, n, pivots);
+}
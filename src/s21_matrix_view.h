@@ -0,0 +1,102 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_VIEW_H
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_VIEW_H
+
+// Non-owning window into the storage of an S21Matrix: a block, a row, a
+// column or a minor. Element (i, j) of the view lives at
+// data + i' * row_stride + j' * col_stride of the parent, where i' and j'
+// step over the skipped row and column of a minor. Writes through a view
+// land in the parent, and a view is only valid while the parent keeps its
+// buffer (no resizing, assignment of another shape or destruction).
+// A view taken from a const matrix, and every transposed view of a matrix,
+// is read-only: SumMatrix, SubMatrix and MulNumber on it throw
+// std::logic_error. Like operator() of a const S21Matrix, its operator()
+// still hands out plain references.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <climits>
+#include <cstddef>
+
+#include "s21_kernels.h"
+
+class S21MatrixView {
+ public:
+  // the whole matrix, writable unless the matrix is const
+  S21MatrixView(S21Matrix& matrix) noexcept;
+  S21MatrixView(const S21Matrix& matrix) noexcept;
+  S21MatrixView(double* data, int rows, int cols, std::ptrdiff_t row_stride,
+                std::ptrdiff_t col_stride = 1);
+
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  std::ptrdiff_t RowStride() const noexcept { return row_stride_; }
+  std::ptrdiff_t ColStride() const noexcept { return col_stride_; }
+  // true when rows are plain arrays: unit column stride, no skipped column
+  bool RowsContiguous() const noexcept {
+    return col_stride_ == 1 && skip_col_ == kNoSkip;
+  }
+  bool IsWritable() const noexcept { return writable_; }
+
+  double& operator()(int row, int col) const;
+  // no bounds check
+  double* At(int row, int col) const noexcept {
+    return data_ + (row + (row >= skip_row_)) * row_stride_ +
+           (col + (col >= skip_col_)) * col_stride_;
+  }
+
+  // sub-views; a minor drops one row and one column, and a view can only
+  // skip one of each, so Minor() of a minor throws std::invalid_argument
+  S21MatrixView Block(int row, int col, int rows, int cols) const;
+  S21MatrixView Row(int row) const;
+  S21MatrixView Col(int col) const;
+  S21MatrixView Minor(int row, int col) const;
+  // the same elements with rows and columns swapped; nothing is copied,
+  // the kernels read the parent through the swapped strides
+  S21MatrixView Transpose() const noexcept;
+  // the same view, read-only
+  S21MatrixView ReadOnly() const noexcept;
+
+  // the same operations as S21Matrix, applied to the viewed elements. An
+  // operand that overlaps the view is copied first, unless it is the view
+  // itself.
+  bool EqMatrix(const S21MatrixView& other) const noexcept;
+  void SumMatrix(const S21MatrixView& other) const;
+  void SubMatrix(const S21MatrixView& other) const;
+  void MulNumber(const double num) const;
+  S21Matrix MulMatrix(const S21MatrixView& other) const;
+  double Determinant() const;
+  double LogDeterminant(int& sign) const;
+  S21Matrix InverseMatrix() const;
+
+ private:
+  static constexpr int kNoSkip = INT_MAX;
+
+  double* data_;
+  int rows_, cols_;
+  std::ptrdiff_t row_stride_, col_stride_;
+  int skip_row_, skip_col_;
+  bool writable_;
+
+  // the GEMM kernels take strided operands but cannot skip lines
+  bool Strideable() const noexcept {
+    return skip_row_ == kNoSkip && skip_col_ == kNoSkip;
+  }
+  s21::kernels::Strided AsStrided() const noexcept {
+    return {data_, row_stride_, col_stride_};
+  }
+  // true when other shares elements with the view in another arrangement,
+  // so that writing the view would change operands not yet read
+  bool Aliases(const S21MatrixView& other) const noexcept;
+  void checkSize(const S21MatrixView& other) const;
+  void checkSquare() const;
+  void checkWritable() const;
+  // copies the square view into the thread's LU scratch, packed, and
+  // factors it; returns the permutation sign, 0 when singular
+  int FactorToScratch(const double** lu) const;
+
+  friend S21Matrix;
+};
+
+S21Matrix operator*(const S21MatrixView& left, const S21MatrixView& right);
+bool operator==(const S21MatrixView& left, const S21MatrixView& right);
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_VIEW_H
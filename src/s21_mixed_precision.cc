@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+std::atomic<std::uint64_t> global_solves{0};
+std::atomic<std::uint64_t> global_iterations{0};
+std::atomic<std::uint64_t> global_fallbacks{0};
+
+double MaxAbs(const S21Matrix& m) {
+  double largest = 0;
+  for (int i = 0; i < m.GetRows(); i++) {
+    const double* row = m.RowData(i);
+    for (int j = 0; j < m.GetCols(); j++) {
+      largest = std::fmax(largest, std::fabs(row[j]));
+    }
+  }
+  return largest;
+}
+
+}  // namespace
+
+// constructors
+S21MixedPrecisionSolver::S21MixedPrecisionSolver(const S21Matrix& matrix,
+                                                 int max_iterations)
+    : matrix_(matrix), float_singular_(false), max_iterations_(1) {
+  SetMaxIterations(max_iterations);
+  const int n = matrix_.GetRows();
+  if (n != matrix_.GetCols()) {
+    throw std::invalid_argument("Error: The matrix must be square");
+  }
+  lu_.resize(static_cast<std::size_t>(n) * n);
+  for (int i = 0; i < n; i++) {
+    std::copy(matrix_.RowData(i), matrix_.RowData(i) + n,
+              lu_.begin() + static_cast<std::ptrdiff_t>(i) * n);
+  }
+  pivots_.assign(n, 0);
+  const double tolerance = n * FLT_EPSILON * MaxAbs(matrix_);
+  float_singular_ =
+      s21::kernels::LuFactor(lu_.data(), n, n, pivots_.data()) == 0;
+  for (int i = 0; i < n && !float_singular_; i++) {
+    float_singular_ =
+        std::fabs(lu_[static_cast<std::size_t>(i) * n + i]) <= tolerance;
+  }
+}
+
+S21MixedPrecisionSolver::~S21MixedPrecisionSolver() = default;
+
+// methods
+S21Matrix S21MixedPrecisionSolver::Solve(const S21Matrix& b,
+                                         Report* report) const {
+  if (b.GetRows() != GetSize()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  S21Matrix x(b.GetRows(), b.GetCols());
+  int iterations = 0;
+  if (!float_singular_ && Refine(b, x, iterations)) {
+    Record(iterations, false, report);
+    return x;
+  }
+  std::call_once(fallback_once_, [this] {
+    fallback_ = std::make_unique<S21LuFactorization>(matrix_);
+  });
+  Record(iterations, true, report);
+  return fallback_->Solve(b);
+}
+
+std::vector<double> S21MixedPrecisionSolver::Solve(
+    const std::vector<double>& b, Report* report) const {
+  S21Matrix column(static_cast<int>(b.size()), 1);
+  for (int i = 0; i < column.GetRows(); i++) column(i, 0) = b[i];
+  const S21Matrix x = Solve(column, report);
+  std::vector<double> res(b.size());
+  for (int i = 0; i < x.GetRows(); i++) res[i] = x(i, 0);
+  return res;
+}
+
+S21Matrix S21MixedPrecisionSolver::InverseMatrix(Report* report) const {
+  const int n = GetSize();
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  return Solve(identity, report);
+}
+
+// accessors
+void S21MixedPrecisionSolver::SetMaxIterations(int value) {
+  if (value < 1) throw std::out_of_range("Error: out of range");
+  max_iterations_ = value;
+}
+
+S21MixedPrecisionSolver::Stats S21MixedPrecisionSolver::GetStats()
+    const noexcept {
+  return {solves_.load(std::memory_order_relaxed),
+          iterations_.load(std::memory_order_relaxed),
+          fallbacks_.load(std::memory_order_relaxed)};
+}
+
+void S21MixedPrecisionSolver::ResetStats() noexcept {
+  solves_.store(0, std::memory_order_relaxed);
+  iterations_.store(0, std::memory_order_relaxed);
+  fallbacks_.store(0, std::memory_order_relaxed);
+}
+
+S21MixedPrecisionSolver::Stats S21MixedPrecisionSolver::GlobalStats() noexcept {
+  return {global_solves.load(std::memory_order_relaxed),
+          global_iterations.load(std::memory_order_relaxed),
+          global_fallbacks.load(std::memory_order_relaxed)};
+}
+
+void S21MixedPrecisionSolver::ResetGlobalStats() noexcept {
+  global_solves.store(0, std::memory_order_relaxed);
+  global_iterations.store(0, std::memory_order_relaxed);
+  global_fallbacks.store(0, std::memory_order_relaxed);
+}
+
+// private methods
+bool S21MixedPrecisionSolver::Refine(const S21Matrix& b, S21Matrix& x,
+                                     int& iterations) const {
+  const int n = GetSize(), k = b.GetCols();
+  std::vector<float> buffer(static_cast<std::size_t>(n) * k);
+  FloatSolve(b, buffer, x);
+  S21Matrix r(n, k), d(n, k);
+  const double eps = S21MatrixTraits<double>::kEpsilon;
+  double previous = std::numeric_limits<double>::infinity();
+  for (iterations = 1; iterations <= max_iterations_; iterations++) {
+    // r = b - A x in double, d = A^-1 r from the float factors
+    s21::kernels::Gemm(n, k, n, matrix_.Data(), matrix_.Stride(), x.Data(),
+                       x.Stride(), r.Data(), r.Stride(), false);
+    for (int i = 0; i < n; i++) {
+      double* row = r.RowData(i);
+      const double* from = b.RowData(i);
+      for (int j = 0; j < k; j++) row[j] = from[j] - row[j];
+    }
+    FloatSolve(r, buffer, d);
+    x.SumMatrix(d);
+    const double correction = MaxAbs(d);
+    if (correction <= eps * std::fmax(1, MaxAbs(x))) return true;
+    // stalled or diverging (NaN included): refinement will not get there
+    if (!(correction <= previous / 2)) return false;
+    previous = correction;
+  }
+  iterations = max_iterations_;
+  return false;
+}
+
+void S21MixedPrecisionSolver::FloatSolve(const S21Matrix& rhs,
+                                         std::vector<float>& buffer,
+                                         S21Matrix& out) const {
+  const int n = rhs.GetRows(), k = rhs.GetCols();
+  for (int i = 0; i < n; i++) {
+    std::copy(rhs.RowData(i), rhs.RowData(i) + k,
+              buffer.begin() + static_cast<std::ptrdiff_t>(i) * k);
+  }
+  s21::kernels::LuSolve(lu_.data(), n, n, pivots_.data(), buffer.data(), k,
+                        k);
+  for (int i = 0; i < n; i++) {
+    std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(i) * k,
+              buffer.begin() + static_cast<std::ptrdiff_t>(i + 1) * k,
+              out.RowData(i));
+  }
+}
+
+void S21MixedPrecisionSolver::Record(int iterations, bool fallback,
+                                     Report* report) const noexcept {
+  solves_.fetch_add(1, std::memory_order_relaxed);
+  iterations_.fetch_add(iterations, std::memory_order_relaxed);
+  fallbacks_.fetch_add(fallback, std::memory_order_relaxed);
+  global_solves.fetch_add(1, std::memory_order_relaxed);
+  global_iterations.fetch_add(iterations, std::memory_order_relaxed);
+  global_fallbacks.fetch_add(fallback, std::memory_order_relaxed);
+  if (report != nullptr) *report = {iterations, fallback};
+}
@@ -0,0 +1,91 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MIXED_PRECISION_H
+#define CPP1_S21_MATRIXPLUS_S21_MIXED_PRECISION_H
+
+// Linear solves at single-precision factorization cost with double
+// accuracy. A is LU-factored once in float. Every solution is then refined:
+// the residual b - A x is computed in double, and each correction is solved
+// with the float factors. Refinement stops once the last correction is
+// within S21MatrixTraits<double>::kEpsilon, the tolerance EqMatrix compares
+// with (relative to max|x| when that exceeds 1). If the corrections stop
+// shrinking, the iteration limit runs out, or the float factors are
+// singular, the solve falls back to a double LU factorization. That
+// factorization is computed on first need and kept. Refinement converges
+// when the condition number of A stays well below 1 / float epsilon
+// (about 1e7).
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class S21MixedPrecisionSolver {
+ public:
+  struct Stats {
+    std::uint64_t solves;
+    // refinement steps over all solves
+    std::uint64_t iterations;
+    // solves finished by the double factorization
+    std::uint64_t fallbacks;
+
+    double FallbackRate() const noexcept {
+      return solves == 0 ? 0 : static_cast<double>(fallbacks) / solves;
+    }
+    double MeanIterations() const noexcept {
+      return solves == 0 ? 0 : static_cast<double>(iterations) / solves;
+    }
+  };
+
+  // outcome of a single solve
+  struct Report {
+    int iterations;
+    bool fallback;
+  };
+
+  // constructors; throw std::invalid_argument for a non-square matrix
+  explicit S21MixedPrecisionSolver(const S21Matrix& matrix,
+                                   int max_iterations = 30);
+  ~S21MixedPrecisionSolver();
+  S21MixedPrecisionSolver(const S21MixedPrecisionSolver&) = delete;
+  S21MixedPrecisionSolver& operator=(const S21MixedPrecisionSolver&) = delete;
+
+  // methods
+  // the solution X of A X = b for n x k b; throws std::out_of_range when
+  // the matrix is singular in double precision too
+  S21Matrix Solve(const S21Matrix& b, Report* report = nullptr) const;
+  std::vector<double> Solve(const std::vector<double>& b,
+                            Report* report = nullptr) const;
+  S21Matrix InverseMatrix(Report* report = nullptr) const;
+
+  // accessors
+  int GetSize() const noexcept { return matrix_.GetRows(); }
+  int GetMaxIterations() const noexcept { return max_iterations_; }
+  // throws std::out_of_range for a limit below 1
+  void SetMaxIterations(int value);
+  // counters of this solver, and of every solver in the process
+  Stats GetStats() const noexcept;
+  void ResetStats() noexcept;
+  static Stats GlobalStats() noexcept;
+  static void ResetGlobalStats() noexcept;
+
+ private:
+  S21Matrix matrix_;
+  std::vector<float> lu_;
+  std::vector<int> pivots_;
+  bool float_singular_;
+  int max_iterations_;
+  mutable std::once_flag fallback_once_;
+  mutable std::unique_ptr<S21LuFactorization> fallback_;
+  mutable std::atomic<std::uint64_t> solves_{0};
+  mutable std::atomic<std::uint64_t> iterations_{0};
+  mutable std::atomic<std::uint64_t> fallbacks_{0};
+
+  // true when refinement converged; x holds the best solution so far
+  bool Refine(const S21Matrix& b, S21Matrix& x, int& iterations) const;
+  void FloatSolve(const S21Matrix& rhs, std::vector<float>& buffer,
+                  S21Matrix& out) const;
+  void Record(int iterations, bool fallback, Report* report) const noexcept;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MIXED_PRECISION_H
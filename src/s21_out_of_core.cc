@@ -0,0 +1,266 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// tile buffers, each TileSize() squared: two for A, B and the product
+constexpr std::size_t kBuffers = 6;
+
+// Runs reads and writes in the order they were posted on a thread of its
+// own. Jobs still queued when the object goes away are finished first.
+class IoThread {
+ public:
+  IoThread() : thread_([this] { Run(); }) {}
+  ~IoThread() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+  }
+  IoThread(const IoThread&) = delete;
+  IoThread& operator=(const IoThread&) = delete;
+
+  // the future rethrows what the job threw
+  std::future<void> Post(std::function<void()> job) {
+    std::packaged_task<void()> task(std::move(job));
+    std::future<void> done = task.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(std::move(task));
+    }
+    ready_.notify_one();
+    return done;
+  }
+
+ private:
+  void Run() {
+    for (;;) {
+      std::packaged_task<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (jobs_.empty()) return;
+        task = std::move(jobs_.front());
+        jobs_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::packaged_task<void()>> jobs_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+// Open descriptor of a matrix file plus its header.
+class TileFile {
+ public:
+  // an existing row-major float64 file
+  explicit TileFile(const std::string& path) : path_(path) {
+    header_ = S21MatrixFile(path).GetHeader();
+    if (header_.dtype != S21MatrixFile::DType::kFloat64 ||
+        header_.layout != S21MatrixFile::Layout::kRowMajor) {
+      throw std::runtime_error("Error: not a row-major float64 file: " + path);
+    }
+    Open(O_RDONLY);
+  }
+  // a new zero-filled file of the given shape
+  TileFile(const std::string& path, int rows, int cols) : path_(path) {
+    const int per_line = static_cast<int>(S21Matrix::kAlignment /
+                                          sizeof(double));
+    const int stride = (cols + per_line - 1) / per_line * per_line;
+    header_ = S21MatrixFile::MakeHeader(rows, cols, stride);
+    Open(O_RDWR | O_CREAT | O_TRUNC);
+    const off_t size = static_cast<off_t>(
+        header_.data_offset + sizeof(double) * header_.rows * header_.stride);
+    if (::ftruncate(fd_, size) != 0) Fail("write");
+    Transfer(&header_, sizeof(header_), 0, true);
+  }
+  ~TileFile() { ::close(fd_); }
+  TileFile(const TileFile&) = delete;
+  TileFile& operator=(const TileFile&) = delete;
+
+  int Rows() const noexcept { return static_cast<int>(header_.rows); }
+  int Cols() const noexcept { return static_cast<int>(header_.cols); }
+  // whether path names this file, under any name
+  bool IsFile(const std::string& path) const {
+    struct stat mine, other;
+    if (::fstat(fd_, &mine) != 0) Fail("read");
+    return ::stat(path.c_str(), &other) == 0 && mine.st_dev == other.st_dev &&
+           mine.st_ino == other.st_ino;
+  }
+
+  // rows x cols elements from (row, col) on, to or from tile (leading
+  // dimension ld)
+  void Read(int row, int col, int rows, int cols, double* tile, int ld) {
+    for (int r = 0; r < rows; r++) {
+      Transfer(tile + static_cast<std::size_t>(r) * ld,
+               sizeof(double) * cols, Offset(row + r, col), false);
+    }
+  }
+  void Write(int row, int col, int rows, int cols, const double* tile,
+             int ld) {
+    for (int r = 0; r < rows; r++) {
+      Transfer(const_cast<double*>(tile) + static_cast<std::size_t>(r) * ld,
+               sizeof(double) * cols, Offset(row + r, col), true);
+    }
+  }
+
+ private:
+  std::string path_;
+  S21MatrixFile::Header header_;
+  int fd_ = -1;
+
+  void Open(int flags) {
+    fd_ = ::open(path_.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd_ < 0) throw std::runtime_error("Error: cannot open " + path_);
+  }
+  [[noreturn]] void Fail(const char* what) const {
+    throw std::runtime_error(std::string("Error: cannot ") + what + " " +
+                             path_);
+  }
+  off_t Offset(int row, int col) const noexcept {
+    return static_cast<off_t>(
+        header_.data_offset +
+        sizeof(double) * (static_cast<std::uint64_t>(row) * header_.stride +
+                          col));
+  }
+  // pread / pwrite until every byte has moved
+  void Transfer(void* data, std::size_t bytes, off_t offset, bool write) {
+    char* p = static_cast<char*>(data);
+    while (bytes > 0) {
+      const ssize_t done = write ? ::pwrite(fd_, p, bytes, offset)
+                                 : ::pread(fd_, p, bytes, offset);
+      if (done <= 0) Fail(write ? "write" : "read");
+      p += done;
+      bytes -= static_cast<std::size_t>(done);
+      offset += done;
+    }
+  }
+};
+
+}  // namespace
+
+S21OutOfCore::S21OutOfCore(std::size_t memory_budget) {
+  SetMemoryBudget(memory_budget);
+}
+
+void S21OutOfCore::SetMemoryBudget(std::size_t bytes) {
+  if (bytes < MinimumBudget()) {
+    throw std::invalid_argument("Error: the memory budget is too small");
+  }
+  memory_budget_ = bytes;
+}
+
+int S21OutOfCore::TileSize() const noexcept {
+  const int depth = s21::kernels::kGemmDepth;
+  const double edge =
+      std::sqrt(static_cast<double>(memory_budget_) /
+                (kBuffers * sizeof(double)));
+  return std::max(1, static_cast<int>(edge) / depth) * depth;
+}
+
+std::size_t S21OutOfCore::MinimumBudget() noexcept {
+  const std::size_t depth = s21::kernels::kGemmDepth;
+  return kBuffers * sizeof(double) * depth * depth;
+}
+
+void S21OutOfCore::MulMatrix(const std::string& a, const std::string& b,
+                             const std::string& result) const {
+  TileFile left(a), right(b);
+  if (left.Cols() != right.Rows()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  // creating the product truncates result before any tile is read
+  if (left.IsFile(result) || right.IsFile(result)) {
+    throw std::invalid_argument("Error: the result file is also an operand");
+  }
+  const int m = left.Rows(), n = right.Cols(), k = left.Cols();
+  TileFile product(result, m, n);
+  if (m == 0 || n == 0 || k == 0) return;
+
+  // the whole inner dimension when it fits in one tile, else tiles that
+  // are multiples of the GEMM depth block
+  const int tile = TileSize();
+  const int tm = std::min(tile, m), tn = std::min(tile, n);
+  const int tk = std::min(tile, k);
+  struct Step {
+    int i, j, p;
+  };
+  std::vector<Step> steps;
+  for (int i = 0; i < m; i += tm) {
+    for (int j = 0; j < n; j += tn) {
+      for (int p = 0; p < k; p += tk) steps.push_back({i, j, p});
+    }
+  }
+  S21Matrix a_tiles[2] = {S21Matrix(tm, tk), S21Matrix(tm, tk)};
+  S21Matrix b_tiles[2] = {S21Matrix(tk, tn), S21Matrix(tk, tn)};
+  S21Matrix c_tiles[2] = {S21Matrix(tm, tn), S21Matrix(tm, tn)};
+  // declared after the buffers, so queued jobs finish before they go
+  IoThread io;
+
+  auto read = [&](std::size_t s) {
+    const Step step = steps[s];
+    S21Matrix* a_tile = &a_tiles[s % 2];
+    S21Matrix* b_tile = &b_tiles[s % 2];
+    const int rows = std::min(tm, m - step.i);
+    const int cols = std::min(tn, n - step.j);
+    const int depth = std::min(tk, k - step.p);
+    return io.Post([&left, &right, step, a_tile, b_tile, rows, cols, depth] {
+      left.Read(step.i, step.p, rows, depth, a_tile->Data(),
+                a_tile->Stride());
+      right.Read(step.p, step.j, depth, cols, b_tile->Data(),
+                 b_tile->Stride());
+    });
+  };
+  std::future<void> loaded = read(0);
+  std::future<void> written[2];
+  int c_slot = 0;
+  for (std::size_t s = 0; s < steps.size(); s++) {
+    loaded.get();
+    // the other buffers were last used by step s - 1, already computed
+    std::future<void> next;
+    if (s + 1 < steps.size()) next = read(s + 1);
+    const Step step = steps[s];
+    const int rows = std::min(tm, m - step.i);
+    const int cols = std::min(tn, n - step.j);
+    const int depth = std::min(tk, k - step.p);
+    S21Matrix& c_tile = c_tiles[c_slot];
+    if (step.p == 0 && written[c_slot].valid()) written[c_slot].get();
+    const S21Matrix& a_tile = a_tiles[s % 2];
+    const S21Matrix& b_tile = b_tiles[s % 2];
+    s21::kernels::Gemm(rows, cols, depth, a_tile.Data(), a_tile.Stride(),
+                       b_tile.Data(), b_tile.Stride(), c_tile.Data(),
+                       c_tile.Stride(), step.p > 0);
+    if (step.p + depth == k) {
+      S21Matrix* finished = &c_tile;
+      written[c_slot] = io.Post([&product, step, finished, rows, cols] {
+        product.Write(step.i, step.j, rows, cols, finished->Data(),
+                      finished->Stride());
+      });
+      c_slot ^= 1;
+    }
+    loaded = std::move(next);
+  }
+  for (std::future<void>& done : written) {
+    if (done.valid()) done.get();
+  }
+}
@@ -0,0 +1,43 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_OUT_OF_CORE_H
+#define CPP1_S21_MATRIXPLUS_S21_OUT_OF_CORE_H
+
+// Products of S21MatrixFile operands too large to hold in memory. The
+// result is computed one square tile at a time: tiles of A and B are read
+// on a background I/O thread while the previous pair is multiplied, and
+// every finished tile of the product is written back while the next one is
+// computed. At most the memory budget is spent on tile buffers (two of
+// each for A, B and the product); Gemm's own packing scratch comes on top.
+// Tiles split the inner dimension at multiples of the GEMM depth block, so
+// the file holds bit for bit what the blocked GEMM of S21Matrix::MulMatrix
+// produces. With S21Strassen enabled, square products it takes over in
+// memory differ from the file within S21Strassen::ErrorBound.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <cstddef>
+#include <string>
+
+class S21OutOfCore {
+ public:
+  // throws std::invalid_argument when the budget cannot hold the smallest
+  // tiles (MinimumBudget())
+  explicit S21OutOfCore(std::size_t memory_budget = std::size_t(256) << 20);
+
+  // writes a * b to result; a and b are row-major float64 matrix files,
+  // result is written so that S21MatrixFile::Load maps it without a copy.
+  // Throws std::out_of_range on mismatched shapes, std::invalid_argument
+  // when result is the same file as a or b and std::runtime_error on I/O
+  // errors.
+  void MulMatrix(const std::string& a, const std::string& b,
+                 const std::string& result) const;
+
+  std::size_t GetMemoryBudget() const noexcept { return memory_budget_; }
+  void SetMemoryBudget(std::size_t bytes);
+  // edge of the square tiles the budget allows
+  int TileSize() const noexcept;
+  static std::size_t MinimumBudget() noexcept;
+
+ private:
+  std::size_t memory_budget_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_OUT_OF_CORE_H
@@ -0,0 +1,34 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_PARALLEL_H
+#define CPP1_S21_MATRIXPLUS_S21_PARALLEL_H
+
+#include <cstddef>
+
+// Settings of the work-stealing pool that S21Matrix operations split large
+// jobs over. The thread count defaults to the number of hardware threads, or
+// to S21_MATRIX_THREADS from the environment.
+class S21Parallel {
+ public:
+  // total number of threads an operation may use, the calling one included;
+  // 1 keeps everything on the caller. Must not race with running operations.
+  static void SetThreadCount(int count);
+  static int GetThreadCount() noexcept;
+  // estimated floating point operations below which a call stays serial
+  static void SetSerialThreshold(std::size_t flops) noexcept;
+  static std::size_t GetSerialThreshold() noexcept;
+};
+
+// Caps the threads used by operations started from the current thread while
+// the object is alive, e.g. to keep the library inside a caller's executor.
+// Limits nest: the innermost one applies.
+class S21ConcurrencyLimit {
+ public:
+  explicit S21ConcurrencyLimit(int max_threads);
+  ~S21ConcurrencyLimit();
+  S21ConcurrencyLimit(const S21ConcurrencyLimit&) = delete;
+  S21ConcurrencyLimit& operator=(const S21ConcurrencyLimit&) = delete;
+
+ private:
+  int previous_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_PARALLEL_H
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+// constructors
+S21QrFactorization::S21QrFactorization(const S21Matrix& matrix)
+    : qr_(matrix) {
+  Factor();
+}
+
+S21QrFactorization::S21QrFactorization(S21Matrix&& matrix)
+    : qr_(std::move(matrix)) {
+  Factor();
+}
+
+// methods
+S21Matrix S21QrFactorization::Solve(const S21Matrix& b) const {
+  using s21::kernels::Strided;
+  if (b.GetRows() != GetRows()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  checkSolvable();
+  const int n = GetCols();
+  S21Matrix y(b);
+  s21::kernels::QrApply(qr_.Data(), GetRows(), n, qr_.Stride(), tau_.data(),
+                        true, y.Data(), y.GetCols(), y.Stride());
+  // the first n rows of Q^T b, solved against R
+  y.SetRows(n);
+  s21::kernels::TriangularSolve(Strided{qr_.Data(), qr_.Stride(), 1}, n,
+                                false, false, y.Data(), y.GetCols(),
+                                y.Stride());
+  return y;
+}
+
+std::vector<double> S21QrFactorization::Solve(
+    const std::vector<double>& b) const {
+  using s21::kernels::Strided;
+  if (static_cast<int>(b.size()) != GetRows()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  checkSolvable();
+  const int n = GetCols();
+  std::vector<double> y(b);
+  s21::kernels::QrApply(qr_.Data(), GetRows(), n, qr_.Stride(), tau_.data(),
+                        true, y.data(), 1, 1);
+  y.resize(n);
+  s21::kernels::TriangularSolve(Strided{qr_.Data(), qr_.Stride(), 1}, n,
+                                false, false, y.data(), 1, 1);
+  return y;
+}
+
+S21Matrix S21QrFactorization::Q() const {
+  const int m = GetRows(), n = GetCols();
+  S21Matrix q(m, n);
+  for (int i = 0; i < n; i++) q(i, i) = 1;
+  s21::kernels::QrApply(qr_.Data(), m, n, qr_.Stride(), tau_.data(), false,
+                        q.Data(), n, q.Stride());
+  return q;
+}
+
+S21Matrix S21QrFactorization::R() const {
+  const int n = GetCols();
+  S21Matrix r(n, n);
+  for (int i = 0; i < n; i++) {
+    std::copy(qr_.RowData(i) + i, qr_.RowData(i) + n, r.RowData(i) + i);
+  }
+  return r;
+}
+
+// private methods
+void S21QrFactorization::Factor() {
+  const int m = GetRows(), n = GetCols();
+  if (m < n) throw std::out_of_range("Error: Wrong matrix size");
+  tau_.assign(n, 0);
+  s21::kernels::QrFactor(qr_.Data(), m, n, qr_.Stride(), tau_.data());
+  double largest = 0;
+  for (int i = 0; i < n; i++) {
+    largest = std::fmax(largest, std::fabs(qr_(i, i)));
+  }
+  const double tolerance =
+      std::max(m, n) * std::numeric_limits<double>::epsilon() * largest;
+  full_rank_ = true;
+  for (int i = 0; i < n && full_rank_; i++) {
+    full_rank_ = std::fabs(qr_(i, i)) > tolerance;
+  }
+}
+
+void S21QrFactorization::checkSolvable() const {
+  if (!full_rank_) {
+    throw std::out_of_range("Error: the matrix is rank deficient");
+  }
+}
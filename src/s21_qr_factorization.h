@@ -0,0 +1,50 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_QR_FACTORIZATION_H
+#define CPP1_S21_MATRIXPLUS_S21_QR_FACTORIZATION_H
+
+// Householder QR factorization A = Q R of an m x n matrix with m >= n,
+// for least-squares fits: Solve(b) minimizes ||A x - b|| through
+// R x = (Q^T b)(0:n), without forming A^T A and squaring its condition
+// number. Q is kept as its reflectors; Q() forms the thin m x n factor
+// on demand. A column is treated as dependent on the ones before it when
+// |r_kk| does not exceed max(m, n) * machine epsilon * max|r_ii|; solving
+// a rank-deficient system throws std::out_of_range.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <vector>
+
+class S21QrFactorization {
+ public:
+  // constructors; throw std::out_of_range when the matrix has fewer rows
+  // than columns
+  explicit S21QrFactorization(const S21Matrix& matrix);
+  // factors in the buffer of matrix
+  explicit S21QrFactorization(S21Matrix&& matrix);
+
+  // methods
+  // the least-squares solution X (n x k) of A X = b for m x k b
+  S21Matrix Solve(const S21Matrix& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  // the thin factors: Q (m x n) with orthonormal columns, R (n x n) upper
+  // triangular
+  S21Matrix Q() const;
+  S21Matrix R() const;
+
+  // accessors
+  int GetRows() const noexcept { return qr_.GetRows(); }
+  int GetCols() const noexcept { return qr_.GetCols(); }
+  bool IsFullRank() const noexcept { return full_rank_; }
+  // R on and above the diagonal, the reflectors H_j = I - tau_j v_j v_j^T
+  // (v_j with an implied leading 1) below it
+  const S21Matrix& Factors() const noexcept { return qr_; }
+  const std::vector<double>& Tau() const noexcept { return tau_; }
+
+ private:
+  S21Matrix qr_;
+  std::vector<double> tau_;
+  bool full_rank_;
+
+  void Factor();
+  void checkSolvable() const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_QR_FACTORIZATION_H
@@ -0,0 +1,422 @@
+#include <immintrin.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "s21_kernels.h"
+
+namespace s21::kernels {
+
+namespace {
+
+// Side of the square blocks the transpose walks, so that both the rows it
+// reads and the rows it writes stay in L1.
+constexpr int kTransposeBlock = 32;
+
+// scalar
+
+void AddScalar(double* a, const double* b, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) a[i] += b[i];
+}
+
+void SubScalar(double* a, const double* b, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) a[i] -= b[i];
+}
+
+void ScaleScalar(double* a, double s, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) a[i] *= s;
+}
+
+bool NearScalar(const double* a, const double* b, std::size_t n, double eps) {
+  for (std::size_t i = 0; i < n; i++) {
+    if (std::fabs(a[i] - b[i]) > eps) return false;
+  }
+  return true;
+}
+
+void TransposeEdge(const double* a, int lda, double* b, int ldb, int i0,
+                   int i1, int j0, int j1) {
+  for (int i = i0; i < i1; i++) {
+    for (int j = j0; j < j1; j++) {
+      b[static_cast<std::size_t>(j) * ldb + i] =
+          a[static_cast<std::size_t>(i) * lda + j];
+    }
+  }
+}
+
+// Walks the matrix in kTransposeBlock squares and hands every full
+// tile x tile piece to the in-register kernel; ragged edges go element-wise.
+template <int tile, typename TileFn>
+void TransposeBlocked(const double* a, int lda, double* b, int ldb, int rows,
+                      int cols, TileFn tile_fn) {
+  for (int ib = 0; ib < rows; ib += kTransposeBlock) {
+    const int ie = ib + kTransposeBlock < rows ? ib + kTransposeBlock : rows;
+    for (int jb = 0; jb < cols; jb += kTransposeBlock) {
+      const int je = jb + kTransposeBlock < cols ? jb + kTransposeBlock : cols;
+      const int it = ib + (ie - ib) / tile * tile;
+      const int jt = jb + (je - jb) / tile * tile;
+      for (int i = ib; i < it; i += tile) {
+        for (int j = jb; j < jt; j += tile) {
+          tile_fn(a + static_cast<std::size_t>(i) * lda + j, lda,
+                  b + static_cast<std::size_t>(j) * ldb + i, ldb);
+        }
+      }
+      TransposeEdge(a, lda, b, ldb, ib, it, jt, je);
+      TransposeEdge(a, lda, b, ldb, it, ie, jb, je);
+    }
+  }
+}
+
+void TransposeScalar(const double* a, int lda, double* b, int ldb, int rows,
+                     int cols) {
+  TransposeBlocked<1>(a, lda, b, ldb, rows, cols,
+                      [](const double* s, int, double* d, int) { *d = *s; });
+}
+
+// SSE2
+
+__attribute__((target("sse2"))) void AddSse2(double* a, const double* b,
+                                             std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(a + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  }
+  for (; i < n; i++) a[i] += b[i];
+}
+
+__attribute__((target("sse2"))) void SubSse2(double* a, const double* b,
+                                             std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(a + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  }
+  for (; i < n; i++) a[i] -= b[i];
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(double* a, double s,
+                                               std::size_t n) {
+  const __m128d f = _mm_set1_pd(s);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(a + i, _mm_mul_pd(_mm_loadu_pd(a + i), f));
+  }
+  for (; i < n; i++) a[i] *= s;
+}
+
+__attribute__((target("sse2"))) bool NearSse2(const double* a,
+                                              const double* b, std::size_t n,
+                                              double eps) {
+  const __m128d abs_mask =
+      _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffff));
+  const __m128d limit = _mm_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128d over = _mm_setzero_pd();
+    for (std::size_t k = 0; k < 8; k += 2) {
+      __m128d d = _mm_sub_pd(_mm_loadu_pd(a + i + k), _mm_loadu_pd(b + i + k));
+      over = _mm_or_pd(over, _mm_cmpgt_pd(_mm_and_pd(d, abs_mask), limit));
+    }
+    if (_mm_movemask_pd(over) != 0) return false;
+  }
+  return NearScalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("sse2"))) void TransposeSse2(const double* a, int lda,
+                                                   double* b, int ldb,
+                                                   int rows, int cols) {
+  TransposeBlocked<2>(
+      a, lda, b, ldb, rows, cols,
+      [](const double* s, int ls, double* d, int ld)
+          __attribute__((target("sse2"))) {
+            __m128d r0 = _mm_loadu_pd(s);
+            __m128d r1 = _mm_loadu_pd(s + ls);
+            _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+            _mm_storeu_pd(d + ld, _mm_unpackhi_pd(r0, r1));
+          });
+}
+
+// AVX2
+
+__attribute__((target("avx2"))) void AddAvx2(double* a, const double* b,
+                                             std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(a + i, _mm256_add_pd(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+  }
+  for (; i < n; i++) a[i] += b[i];
+}
+
+__attribute__((target("avx2"))) void SubAvx2(double* a, const double* b,
+                                             std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(a + i, _mm256_sub_pd(_mm256_loadu_pd(a + i),
+                                          _mm256_loadu_pd(b + i)));
+  }
+  for (; i < n; i++) a[i] -= b[i];
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(double* a, double s,
+                                               std::size_t n) {
+  const __m256d f = _mm256_set1_pd(s);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), f));
+  }
+  for (; i < n; i++) a[i] *= s;
+}
+
+__attribute__((target("avx2"))) bool NearAvx2(const double* a,
+                                              const double* b, std::size_t n,
+                                              double eps) {
+  const __m256d abs_mask =
+      _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+  const __m256d limit = _mm256_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256d over = _mm256_setzero_pd();
+    for (std::size_t k = 0; k < 16; k += 4) {
+      __m256d d = _mm256_sub_pd(_mm256_loadu_pd(a + i + k),
+                                _mm256_loadu_pd(b + i + k));
+      over = _mm256_or_pd(
+          over, _mm256_cmp_pd(_mm256_and_pd(d, abs_mask), limit, _CMP_GT_OQ));
+    }
+    if (_mm256_movemask_pd(over) != 0) return false;
+  }
+  return NearScalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx2"))) void TransposeAvx2(const double* a, int lda,
+                                                   double* b, int ldb,
+                                                   int rows, int cols) {
+  TransposeBlocked<4>(
+      a, lda, b, ldb, rows, cols,
+      [](const double* s, int ls, double* d, int ld)
+          __attribute__((target("avx2"))) {
+            __m256d r0 = _mm256_loadu_pd(s);
+            __m256d r1 = _mm256_loadu_pd(s + ls);
+            __m256d r2 = _mm256_loadu_pd(s + 2 * ls);
+            __m256d r3 = _mm256_loadu_pd(s + 3 * ls);
+            __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+            __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+            __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+            __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+            _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+            _mm256_storeu_pd(d + ld, _mm256_permute2f128_pd(t1, t3, 0x20));
+            _mm256_storeu_pd(d + 2 * ld, _mm256_permute2f128_pd(t0, t2, 0x31));
+            _mm256_storeu_pd(d + 3 * ld, _mm256_permute2f128_pd(t1, t3, 0x31));
+          });
+}
+
+// AVX-512
+
+__attribute__((target("avx512f"))) void AddAvx512(double* a, const double* b,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(a + i, _mm512_add_pd(_mm512_loadu_pd(a + i),
+                                          _mm512_loadu_pd(b + i)));
+  }
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(a + i, m,
+                          _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                        _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(double* a, const double* b,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(a + i, _mm512_sub_pd(_mm512_loadu_pd(a + i),
+                                          _mm512_loadu_pd(b + i)));
+  }
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(a + i, m,
+                          _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i),
+                                        _mm512_maskz_loadu_pd(m, b + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(double* a, double s,
+                                                    std::size_t n) {
+  const __m512d f = _mm512_set1_pd(s);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(a + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), f));
+  }
+  if (i < n) {
+    const __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(a + i, m,
+                          _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), f));
+  }
+}
+
+__attribute__((target("avx512f"))) bool NearAvx512(const double* a,
+                                                   const double* b,
+                                                   std::size_t n, double eps) {
+  const __m512d limit = _mm512_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __mmask8 over = 0;
+    for (std::size_t k = 0; k < 32; k += 8) {
+      __m512d d = _mm512_sub_pd(_mm512_loadu_pd(a + i + k),
+                                _mm512_loadu_pd(b + i + k));
+      over |= _mm512_cmp_pd_mask(_mm512_abs_pd(d), limit, _CMP_GT_OQ);
+    }
+    if (over != 0) return false;
+  }
+  return NearScalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx512f"))) void TransposeAvx512(const double* a,
+                                                        int lda, double* b,
+                                                        int ldb, int rows,
+                                                        int cols) {
+  TransposeBlocked<8>(
+      a, lda, b, ldb, rows, cols,
+      [](const double* s, int ls, double* d, int ld)
+          __attribute__((target("avx512f"))) {
+            __m512d t[8];
+            for (int r = 0; r < 8; r += 2) {
+              __m512d lo = _mm512_loadu_pd(s + r * ls);
+              __m512d hi = _mm512_loadu_pd(s + (r + 1) * ls);
+              // the unmasked unpacks trip -Wuninitialized in GCC 12 headers
+              t[r] = _mm512_maskz_unpacklo_pd(0xff, lo, hi);
+              t[r + 1] = _mm512_maskz_unpackhi_pd(0xff, lo, hi);
+            }
+            // pairs of rows -> quads of rows, then quads -> full columns
+            const __m512i even = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+            const __m512i odd = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+            const __m512i low = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+            const __m512i high = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+            __m512d q[8];
+            for (int h = 0; h < 8; h += 4) {
+              q[h] = _mm512_permutex2var_pd(t[h], even, t[h + 2]);
+              q[h + 1] = _mm512_permutex2var_pd(t[h + 1], even, t[h + 3]);
+              q[h + 2] = _mm512_permutex2var_pd(t[h], odd, t[h + 2]);
+              q[h + 3] = _mm512_permutex2var_pd(t[h + 1], odd, t[h + 3]);
+            }
+            for (int c = 0; c < 4; c++) {
+              _mm512_storeu_pd(d + c * ld,
+                               _mm512_permutex2var_pd(q[c], low, q[c + 4]));
+              _mm512_storeu_pd(d + (c + 4) * ld,
+                               _mm512_permutex2var_pd(q[c], high, q[c + 4]));
+            }
+          });
+}
+
+const ElementwiseKernels kKernels[] = {
+    {AddScalar, SubScalar, ScaleScalar, NearScalar, TransposeScalar},
+    {AddSse2, SubSse2, ScaleSse2, NearSse2, TransposeSse2},
+    {AddAvx2, SubAvx2, ScaleAvx2, NearAvx2, TransposeAvx2},
+    {AddAvx512, SubAvx512, ScaleAvx512, NearAvx512, TransposeAvx512},
+};
+
+SimdLevel HardwareSimdLevel() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SimdLevel::kAvx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse2")) return SimdLevel::kSse2;
+  return SimdLevel::kScalar;
+}
+
+// S21_MATRIX_SIMD=scalar|sse2|avx2|avx512 caps the level picked at startup.
+SimdLevel StartupSimdLevel() {
+  SimdLevel level = HardwareSimdLevel();
+  const char* env = std::getenv("S21_MATRIX_SIMD");
+  if (env != nullptr) {
+    const char* names[] = {"scalar", "sse2", "avx2", "avx512"};
+    for (int i = 0; i < 4; i++) {
+      if (std::strcmp(env, names[i]) == 0 && i < static_cast<int>(level)) {
+        level = static_cast<SimdLevel>(i);
+      }
+    }
+  }
+  return level;
+}
+
+// Exchanges the rows x cols block at a with the cols x rows block at b,
+// transposing both. The longer side is halved until the blocks fit in L1,
+// so the recursion stays cache friendly without knowing the cache sizes.
+void SwapTransposed(double* a, double* b, int rows, int cols, int ld,
+                    double* tmp) {
+  if (rows <= kTransposeBlock && cols <= kTransposeBlock) {
+    const auto transpose = Elementwise().transpose;
+    for (int i = 0; i < rows; i++) {
+      std::memcpy(tmp + i * kTransposeBlock,
+                  a + static_cast<std::size_t>(i) * ld, sizeof(double) * cols);
+    }
+    transpose(b, ld, a, ld, cols, rows);
+    transpose(tmp, kTransposeBlock, b, ld, rows, cols);
+    return;
+  }
+  if (rows >= cols) {
+    const int half = rows / 2;
+    SwapTransposed(a, b, half, cols, ld, tmp);
+    SwapTransposed(a + static_cast<std::size_t>(half) * ld, b + half,
+                   rows - half, cols, ld, tmp);
+  } else {
+    const int half = cols / 2;
+    SwapTransposed(a, b, rows, half, ld, tmp);
+    SwapTransposed(a + half, b + static_cast<std::size_t>(half) * ld, rows,
+                   cols - half, ld, tmp);
+  }
+}
+
+// Transposes the n x n diagonal block at a: both diagonal quadrants in
+// place, then the two off-diagonal ones swapped.
+void TransposeDiagonal(double* a, int n, int ld, double* tmp) {
+  if (n <= kTransposeBlock) {
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        std::swap(a[static_cast<std::size_t>(i) * ld + j],
+                  a[static_cast<std::size_t>(j) * ld + i]);
+      }
+    }
+    return;
+  }
+  const int half = n / 2;
+  const std::size_t corner = static_cast<std::size_t>(half) * ld + half;
+  TransposeDiagonal(a, half, ld, tmp);
+  TransposeDiagonal(a + corner, n - half, ld, tmp);
+  SwapTransposed(a + half, a + static_cast<std::size_t>(half) * ld, half,
+                 n - half, ld, tmp);
+}
+
+std::atomic<SimdLevel>& ActiveLevel() {
+  static std::atomic<SimdLevel> level(StartupSimdLevel());
+  return level;
+}
+
+}  // namespace
+
+SimdLevel ActiveSimdLevel() noexcept {
+  return ActiveLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel SetSimdLevel(SimdLevel level) noexcept {
+  static const SimdLevel hardware = HardwareSimdLevel();
+  if (level > hardware) level = hardware;
+  ActiveLevel().store(level, std::memory_order_relaxed);
+  return level;
+}
+
+const ElementwiseKernels& Elementwise() noexcept {
+  return kKernels[static_cast<int>(ActiveSimdLevel())];
+}
+
+void TransposeInPlace(double* a, int n, int lda) noexcept {
+  double tmp[kTransposeBlock * kTransposeBlock];
+  TransposeDiagonal(a, n, lda, tmp);
+}
+
+}  // namespace s21::kernels
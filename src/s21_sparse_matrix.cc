@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// rows per chunk when products are split across threads
+constexpr std::size_t kRowGrain = 64;
+
+}  // namespace
+
+// constructors
+S21SparseMatrix::S21SparseMatrix()
+    : rows_(0), cols_(0), format_(Format::kCsr), offsets_(1, 0) {}
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols, Format format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows < 0 || cols < 0) throw std::out_of_range("Error: out of range");
+  offsets_.assign(Majors() + 1, 0);
+}
+
+S21SparseMatrix::S21SparseMatrix(const S21Matrix& dense, double tolerance,
+                                 Format format)
+    : S21SparseMatrix(dense.GetRows(), dense.GetCols(), format) {
+  const bool csr = format_ == Format::kCsr;
+  for (int k = 0; k < Majors(); k++) {
+    for (int l = 0; l < Minors(); l++) {
+      const double v = csr ? dense.RowData(k)[l] : dense.RowData(l)[k];
+      if (std::fabs(v) > tolerance) {
+        indices_.push_back(l);
+        values_.push_back(v);
+      }
+    }
+    offsets_[k + 1] = NonZeros();
+  }
+}
+
+S21SparseMatrix S21SparseMatrix::FromTriplets(
+    int rows, int cols, const std::vector<Triplet>& triplets, Format format) {
+  S21SparseMatrix m(rows, cols, format);
+  const bool csr = format == Format::kCsr;
+  const int majors = m.Majors();
+  // bucket by row (column), then sort and merge every bucket
+  std::vector<int> start(majors + 1, 0);
+  for (const Triplet& t : triplets) {
+    if (t.row < 0 || t.col < 0 || t.row >= rows || t.col >= cols) {
+      throw std::out_of_range("Error: out of range");
+    }
+    start[(csr ? t.row : t.col) + 1]++;
+  }
+  std::partial_sum(start.begin(), start.end(), start.begin());
+  std::vector<std::pair<int, double>> entries(triplets.size());
+  std::vector<int> next(start.begin(), start.end() - 1);
+  for (const Triplet& t : triplets) {
+    entries[next[csr ? t.row : t.col]++] = {csr ? t.col : t.row, t.value};
+  }
+  m.indices_.reserve(entries.size());
+  m.values_.reserve(entries.size());
+  for (int k = 0; k < majors; k++) {
+    const auto first = entries.begin() + start[k];
+    const auto last = entries.begin() + start[k + 1];
+    std::sort(first, last, [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+    const int segment = m.NonZeros();
+    for (auto e = first; e != last; ++e) {
+      if (m.NonZeros() > segment && m.indices_.back() == e->first) {
+        m.values_.back() += e->second;
+      } else {
+        m.indices_.push_back(e->first);
+        m.values_.push_back(e->second);
+      }
+    }
+    m.offsets_[k + 1] = m.NonZeros();
+  }
+  return m;
+}
+
+// methods
+bool S21SparseMatrix::EqMatrix(const S21SparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  const S21SparseMatrix converted =
+      other.format_ == format_ ? S21SparseMatrix() : other.ToFormat(format_);
+  const S21SparseMatrix& b = other.format_ == format_ ? other : converted;
+  const double eps = S21MatrixTraits<double>::kEpsilon;
+  for (int k = 0; k < Majors(); k++) {
+    int p = offsets_[k], q = b.offsets_[k];
+    const int p_end = offsets_[k + 1], q_end = b.offsets_[k + 1];
+    while (p < p_end || q < q_end) {
+      double diff;
+      if (q == q_end || (p < p_end && indices_[p] < b.indices_[q])) {
+        diff = values_[p++];
+      } else if (p == p_end || b.indices_[q] < indices_[p]) {
+        diff = b.values_[q++];
+      } else {
+        diff = values_[p++] - b.values_[q++];
+      }
+      if (std::fabs(diff) > eps) return false;
+    }
+  }
+  return true;
+}
+
+void S21SparseMatrix::SumMatrix(const S21SparseMatrix& other) {
+  Combine(other, 1);
+}
+
+void S21SparseMatrix::SubMatrix(const S21SparseMatrix& other) {
+  Combine(other, -1);
+}
+
+void S21SparseMatrix::MulNumber(const double num) noexcept {
+  for (double& v : values_) v *= num;
+}
+
+// Gustavson's row-by-row product on the CSR forms: row i of the result
+// gathers row k of other scaled by every a_ik. A first pass sizes each
+// row, so the second can fill them in parallel without reallocation.
+void S21SparseMatrix::MulMatrix(const S21SparseMatrix& other) {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  const S21SparseMatrix a = ToFormat(Format::kCsr);
+  const S21SparseMatrix b = other.ToFormat(Format::kCsr);
+  const int n = other.cols_;
+  S21SparseMatrix result(rows_, n);
+  const std::size_t flops =
+      2 * static_cast<std::size_t>(a.NonZeros()) *
+      (b.NonZeros() / std::max(b.rows_, 1) + 1);
+  std::vector<int>& offsets = result.offsets_;
+  s21::kernels::ParallelFor(
+      rows_, kRowGrain, flops, [&](std::size_t begin, std::size_t end) {
+        int* marker = s21::kernels::Scratch<int>(
+            n, s21::kernels::kScratchPivots);
+        std::fill_n(marker, n, -1);
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end);
+             i++) {
+          int count = 0;
+          for (int p = a.offsets_[i]; p < a.offsets_[i + 1]; p++) {
+            const int k = a.indices_[p];
+            for (int q = b.offsets_[k]; q < b.offsets_[k + 1]; q++) {
+              const int j = b.indices_[q];
+              if (marker[j] != i) {
+                marker[j] = i;
+                count++;
+              }
+            }
+          }
+          offsets[i + 1] = count;
+        }
+      });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  result.indices_.resize(offsets.back());
+  result.values_.resize(offsets.back());
+  s21::kernels::ParallelFor(
+      rows_, kRowGrain, flops, [&](std::size_t begin, std::size_t end) {
+        using namespace s21::kernels;
+        int* marker = Scratch<int>(n, kScratchPivots);
+        double* sums = Scratch<double>(n, kScratchRows);
+        std::fill_n(marker, n, -1);
+        for (int i = static_cast<int>(begin); i < static_cast<int>(end);
+             i++) {
+          int* indices = result.indices_.data() + offsets[i];
+          int count = 0;
+          for (int p = a.offsets_[i]; p < a.offsets_[i + 1]; p++) {
+            const int k = a.indices_[p];
+            const double v = a.values_[p];
+            for (int q = b.offsets_[k]; q < b.offsets_[k + 1]; q++) {
+              const int j = b.indices_[q];
+              if (marker[j] != i) {
+                marker[j] = i;
+                indices[count++] = j;
+                sums[j] = v * b.values_[q];
+              } else {
+                sums[j] += v * b.values_[q];
+              }
+            }
+          }
+          std::sort(indices, indices + count);
+          double* values = result.values_.data() + offsets[i];
+          for (int e = 0; e < count; e++) values[e] = sums[indices[e]];
+        }
+      });
+  *this = format_ == Format::kCsr ? std::move(result)
+                                  : result.ToFormat(Format::kCsc);
+}
+
+S21Matrix S21SparseMatrix::MulMatrix(const S21Matrix& other) const {
+  if (cols_ != other.GetRows()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  const S21SparseMatrix converted =
+      format_ == Format::kCsr ? S21SparseMatrix() : ToFormat(Format::kCsr);
+  const S21SparseMatrix& a = format_ == Format::kCsr ? *this : converted;
+  const int n = other.GetCols();
+  S21Matrix result(rows_, n);
+  s21::kernels::ParallelFor(
+      rows_, kRowGrain, 2 * static_cast<std::size_t>(NonZeros()) * n,
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          double* c_row = result.RowData(static_cast<int>(i));
+          for (int p = a.offsets_[i]; p < a.offsets_[i + 1]; p++) {
+            const double v = a.values_[p];
+            const double* b_row = other.RowData(a.indices_[p]);
+            for (int j = 0; j < n; j++) c_row[j] += v * b_row[j];
+          }
+        }
+      });
+  return result;
+}
+
+std::vector<double> S21SparseMatrix::MulVector(
+    const std::vector<double>& x) const {
+  if (x.size() != static_cast<std::size_t>(cols_)) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  std::vector<double> y(rows_, 0.0);
+  if (format_ == Format::kCsc) {
+    // columns scatter into y, so this stays on one thread
+    for (int j = 0; j < cols_; j++) {
+      for (int p = offsets_[j]; p < offsets_[j + 1]; p++) {
+        y[indices_[p]] += values_[p] * x[j];
+      }
+    }
+    return y;
+  }
+  s21::kernels::ParallelFor(
+      rows_, 256, 2 * static_cast<std::size_t>(NonZeros()),
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          double sum = 0;
+          for (int p = offsets_[i]; p < offsets_[i + 1]; p++) {
+            sum += values_[p] * x[indices_[p]];
+          }
+          y[i] = sum;
+        }
+      });
+  return y;
+}
+
+S21SparseMatrix S21SparseMatrix::Transpose() const {
+  // rows stored as CSR read as the columns of the transpose in CSC
+  S21SparseMatrix result(*this);
+  std::swap(result.rows_, result.cols_);
+  result.format_ =
+      format_ == Format::kCsr ? Format::kCsc : Format::kCsr;
+  return result;
+}
+
+void S21SparseMatrix::Prune(double tolerance) {
+  int kept = 0;
+  int begin = 0;
+  for (int k = 0; k < Majors(); k++) {
+    const int end = offsets_[k + 1];
+    for (int p = begin; p < end; p++) {
+      if (std::fabs(values_[p]) > tolerance) {
+        indices_[kept] = indices_[p];
+        values_[kept++] = values_[p];
+      }
+    }
+    begin = end;
+    offsets_[k + 1] = kept;
+  }
+  indices_.resize(kept);
+  values_.resize(kept);
+}
+
+S21Matrix S21SparseMatrix::ToDense() const {
+  S21Matrix dense(rows_, cols_);
+  const bool csr = format_ == Format::kCsr;
+  for (int k = 0; k < Majors(); k++) {
+    for (int p = offsets_[k]; p < offsets_[k + 1]; p++) {
+      const int l = indices_[p];
+      (csr ? dense.RowData(k)[l] : dense.RowData(l)[k]) = values_[p];
+    }
+  }
+  return dense;
+}
+
+S21SparseMatrix S21SparseMatrix::ToFormat(Format format) const {
+  if (format == format_) return *this;
+  // counting sort by the old minor index; walking the old majors in order
+  // leaves every new segment sorted
+  S21SparseMatrix result(rows_, cols_, format);
+  std::vector<int>& offsets = result.offsets_;
+  for (int index : indices_) offsets[index + 1]++;
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  result.indices_.resize(indices_.size());
+  result.values_.resize(values_.size());
+  std::vector<int> next(offsets.begin(), offsets.end() - 1);
+  for (int k = 0; k < Majors(); k++) {
+    for (int p = offsets_[k]; p < offsets_[k + 1]; p++) {
+      const int slot = next[indices_[p]]++;
+      result.indices_[slot] = k;
+      result.values_[slot] = values_[p];
+    }
+  }
+  return result;
+}
+
+// operators
+double S21SparseMatrix::operator()(int row, int col) const {
+  if (cols_ <= col || rows_ <= row || row < 0 || col < 0) {
+    throw std::out_of_range("Error: out of range");
+  }
+  const bool csr = format_ == Format::kCsr;
+  const int k = csr ? row : col, l = csr ? col : row;
+  const auto first = indices_.begin() + offsets_[k];
+  const auto last = indices_.begin() + offsets_[k + 1];
+  const auto it = std::lower_bound(first, last, l);
+  return it != last && *it == l ? values_[it - indices_.begin()] : 0.0;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator+=(const S21SparseMatrix& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator-=(const S21SparseMatrix& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator*=(const double num) noexcept {
+  MulNumber(num);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator*=(const S21SparseMatrix& other) {
+  MulMatrix(other);
+  return *this;
+}
+
+bool S21SparseMatrix::operator==(const S21SparseMatrix& other) const {
+  return EqMatrix(other);
+}
+
+S21SparseMatrix S21SparseMatrix::operator+(
+    const S21SparseMatrix& other) const {
+  S21SparseMatrix result(*this);
+  result.SumMatrix(other);
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::operator-(
+    const S21SparseMatrix& other) const {
+  S21SparseMatrix result(*this);
+  result.SubMatrix(other);
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::operator*(
+    const S21SparseMatrix& other) const {
+  S21SparseMatrix result(*this);
+  result.MulMatrix(other);
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::operator*(const double num) const {
+  S21SparseMatrix result(*this);
+  result.MulNumber(num);
+  return result;
+}
+
+S21Matrix S21SparseMatrix::operator*(const S21Matrix& other) const {
+  return MulMatrix(other);
+}
+
+std::vector<double> S21SparseMatrix::operator*(
+    const std::vector<double>& x) const {
+  return MulVector(x);
+}
+
+S21Matrix operator*(const S21Matrix& left, const S21SparseMatrix& right) {
+  if (left.GetCols() != right.GetRows()) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+  const S21SparseMatrix b = right.ToFormat(S21SparseMatrix::Format::kCsr);
+  const std::vector<int>& offsets = b.Offsets();
+  const std::vector<int>& indices = b.Indices();
+  const std::vector<double>& values = b.Values();
+  const int k = left.GetCols();
+  S21Matrix result(left.GetRows(), b.GetCols());
+  s21::kernels::ParallelFor(
+      left.GetRows(), kRowGrain,
+      2 * static_cast<std::size_t>(left.GetRows()) * b.NonZeros(),
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          const double* a_row = left.RowData(static_cast<int>(i));
+          double* c_row = result.RowData(static_cast<int>(i));
+          for (int p = 0; p < k; p++) {
+            const double a = a_row[p];
+            if (a == 0) continue;
+            for (int q = offsets[p]; q < offsets[p + 1]; q++) {
+              c_row[indices[q]] += a * values[q];
+            }
+          }
+        }
+      });
+  return result;
+}
+
+// private methods
+int S21SparseMatrix::Majors() const noexcept {
+  return format_ == Format::kCsr ? rows_ : cols_;
+}
+
+int S21SparseMatrix::Minors() const noexcept {
+  return format_ == Format::kCsr ? cols_ : rows_;
+}
+
+// this += sign * other, merging the sorted segments pairwise
+void S21SparseMatrix::Combine(const S21SparseMatrix& other, double sign) {
+  checkSize(other);
+  const S21SparseMatrix converted =
+      other.format_ == format_ ? S21SparseMatrix() : other.ToFormat(format_);
+  const S21SparseMatrix& b = other.format_ == format_ ? other : converted;
+  std::vector<int> offsets(Majors() + 1, 0);
+  std::vector<int> indices;
+  std::vector<double> values;
+  indices.reserve(indices_.size() + b.indices_.size());
+  values.reserve(indices_.size() + b.indices_.size());
+  for (int k = 0; k < Majors(); k++) {
+    int p = offsets_[k], q = b.offsets_[k];
+    const int p_end = offsets_[k + 1], q_end = b.offsets_[k + 1];
+    while (p < p_end || q < q_end) {
+      if (q == q_end || (p < p_end && indices_[p] < b.indices_[q])) {
+        indices.push_back(indices_[p]);
+        values.push_back(values_[p++]);
+      } else if (p == p_end || b.indices_[q] < indices_[p]) {
+        indices.push_back(b.indices_[q]);
+        values.push_back(sign * b.values_[q++]);
+      } else {
+        indices.push_back(indices_[p]);
+        values.push_back(values_[p++] + sign * b.values_[q++]);
+      }
+    }
+    offsets[k + 1] = static_cast<int>(indices.size());
+  }
+  offsets_ = std::move(offsets);
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+
+void S21SparseMatrix::checkSize(const S21SparseMatrix& other) const {
+  if (other.rows_ != rows_ || other.cols_ != cols_) {
+    throw std::out_of_range("Error: Wrong matrix size");
+  }
+}
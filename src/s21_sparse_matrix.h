@@ -0,0 +1,103 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_SPARSE_MATRIX_H
+#define CPP1_S21_MATRIXPLUS_S21_SPARSE_MATRIX_H
+
+// Compressed sparse matrix for the mostly-zero matrices S21Matrix would
+// store and multiply densely. Only non-zero elements are kept, grouped by
+// row (kCsr) or by column (kCsc): the elements of row (column) k are
+// Indices()[Offsets()[k] .. Offsets()[k + 1]), sorted, with the matching
+// Values(). Transpose() only reinterprets the arrays, which is why both
+// formats exist; operations that need the other one convert on the fly.
+// Included from s21_matrix_oop.h, not meant to be included directly.
+
+#include <vector>
+
+class S21SparseMatrix {
+ public:
+  enum class Format { kCsr, kCsc };
+
+  struct Triplet {
+    int row;
+    int col;
+    double value;
+  };
+
+  // constructors
+  S21SparseMatrix();
+  // a rows x cols matrix without non-zero elements
+  S21SparseMatrix(int rows, int cols, Format format = Format::kCsr);
+  // keeps the elements of dense whose magnitude exceeds tolerance; the
+  // default drops exactly what EqMatrix could not tell from zero anyway
+  explicit S21SparseMatrix(
+      const S21Matrix& dense,
+      double tolerance = S21MatrixTraits<double>::kEpsilon,
+      Format format = Format::kCsr);
+  // elements in any order; duplicates are summed
+  static S21SparseMatrix FromTriplets(int rows, int cols,
+                                      const std::vector<Triplet>& triplets,
+                                      Format format = Format::kCsr);
+
+  // methods
+  bool EqMatrix(const S21SparseMatrix& other) const;
+  void SumMatrix(const S21SparseMatrix& other);
+  void SubMatrix(const S21SparseMatrix& other);
+  void MulNumber(const double num) noexcept;
+  // sparse x sparse, in place like S21Matrix::MulMatrix
+  void MulMatrix(const S21SparseMatrix& other);
+  // sparse x dense
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  // sparse x vector
+  std::vector<double> MulVector(const std::vector<double>& x) const;
+  S21SparseMatrix Transpose() const;
+  // removes the stored elements whose magnitude does not exceed tolerance,
+  // e.g. the zeros cancellation leaves behind in sums
+  void Prune(double tolerance = S21MatrixTraits<double>::kEpsilon);
+  S21Matrix ToDense() const;
+  // the same matrix compressed the other way round when format differs
+  S21SparseMatrix ToFormat(Format format) const;
+
+  // operators
+  // element (row, col), zero when it is not stored
+  double operator()(int row, int col) const;
+  S21SparseMatrix& operator+=(const S21SparseMatrix& other);
+  S21SparseMatrix& operator-=(const S21SparseMatrix& other);
+  S21SparseMatrix& operator*=(const double num) noexcept;
+  S21SparseMatrix& operator*=(const S21SparseMatrix& other);
+  bool operator==(const S21SparseMatrix& other) const;
+  S21SparseMatrix operator+(const S21SparseMatrix& other) const;
+  S21SparseMatrix operator-(const S21SparseMatrix& other) const;
+  S21SparseMatrix operator*(const S21SparseMatrix& other) const;
+  S21SparseMatrix operator*(const double num) const;
+  S21Matrix operator*(const S21Matrix& other) const;
+  std::vector<double> operator*(const std::vector<double>& x) const;
+  friend S21SparseMatrix operator*(const double num,
+                                   const S21SparseMatrix& m) {
+    return m * num;
+  }
+
+  // accessors
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  Format GetFormat() const noexcept { return format_; }
+  int NonZeros() const noexcept { return static_cast<int>(values_.size()); }
+  const std::vector<int>& Offsets() const noexcept { return offsets_; }
+  const std::vector<int>& Indices() const noexcept { return indices_; }
+  const std::vector<double>& Values() const noexcept { return values_; }
+
+ private:
+  int rows_, cols_;
+  Format format_;
+  std::vector<int> offsets_;
+  std::vector<int> indices_;
+  std::vector<double> values_;
+
+  // rows for kCsr, columns for kCsc
+  int Majors() const noexcept;
+  int Minors() const noexcept;
+  void Combine(const S21SparseMatrix& other, double sign);
+  void checkSize(const S21SparseMatrix& other) const;
+};
+
+// dense x sparse
+S21Matrix operator*(const S21Matrix& left, const S21SparseMatrix& right);
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_SPARSE_MATRIX_H
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_kernels.h"
+#include "s21_strassen.h"
+
+namespace s21::kernels {
+
+namespace {
+
+int DefaultThreshold() {
+  const char* env = std::getenv("S21_MATRIX_STRASSEN");
+  if (env != nullptr && std::atoi(env) > 0) return std::atoi(env);
+  return 0;
+}
+
+std::atomic<int> strassen_threshold(DefaultThreshold());
+// below about this order the saved block product no longer pays for the
+// extra additions and their memory traffic
+std::atomic<int> strassen_crossover(384);
+
+// d = x + sign * y for h x h blocks; d may be x or y
+void Combine(int h, double* d, int ldd, const double* x, int ldx,
+             const double* y, int ldy, double sign) {
+  CountFlops(S21Instrumentation::kStrassen, static_cast<std::size_t>(h) * h);
+  ParallelFor(h, 64, static_cast<std::size_t>(h) * h,
+              [=](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                  double* d_row = d + i * ldd;
+                  const double* x_row = x + i * ldx;
+                  const double* y_row = y + i * ldy;
+                  for (int j = 0; j < h; j++) {
+                    d_row[j] = x_row[j] + sign * y_row[j];
+                  }
+                }
+              });
+}
+
+// Winograd's variant (7 products, 15 additions) in the schedule of
+// Douglas et al., which needs two block temporaries per level and writes
+// the partial products straight into the quadrants of C.
+void Winograd(int n, const double* a, int lda, const double* b, int ldb,
+              double* c, int ldc, int crossover, double* workspace) {
+  if (n <= crossover || n % 2 != 0) {
+    Gemm(n, n, n, a, lda, b, ldb, c, ldc, false);
+    return;
+  }
+  const int h = n / 2;
+  const std::size_t down_a = static_cast<std::size_t>(h) * lda;
+  const std::size_t down_b = static_cast<std::size_t>(h) * ldb;
+  const std::size_t down_c = static_cast<std::size_t>(h) * ldc;
+  const double *a11 = a, *a12 = a + h, *a21 = a + down_a,
+               *a22 = a + down_a + h;
+  const double *b11 = b, *b12 = b + h, *b21 = b + down_b,
+               *b22 = b + down_b + h;
+  double *c11 = c, *c12 = c + h, *c21 = c + down_c, *c22 = c + down_c + h;
+  double* x = workspace;
+  double* y = x + static_cast<std::size_t>(h) * h;
+  double* deeper = y + static_cast<std::size_t>(h) * h;
+  auto multiply = [=](const double* l, int ldl, const double* r, int ldr,
+                      double* p, int ldp) {
+    Winograd(h, l, ldl, r, ldr, p, ldp, crossover, deeper);
+  };
+  Combine(h, x, h, a11, lda, a21, lda, -1);      // S3 = A11 - A21
+  Combine(h, y, h, b22, ldb, b12, ldb, -1);      // T3 = B22 - B12
+  multiply(x, h, y, h, c21, ldc);                // P7 = S3 T3
+  Combine(h, x, h, a21, lda, a22, lda, 1);       // S1 = A21 + A22
+  Combine(h, y, h, b12, ldb, b11, ldb, -1);      // T1 = B12 - B11
+  multiply(x, h, y, h, c22, ldc);                // P5 = S1 T1
+  Combine(h, x, h, x, h, a11, lda, -1);          // S2 = S1 - A11
+  Combine(h, y, h, b22, ldb, y, h, -1);          // T2 = B22 - T1
+  multiply(x, h, y, h, c12, ldc);                // P6 = S2 T2
+  Combine(h, x, h, a12, lda, x, h, -1);          // S4 = A12 - S2
+  multiply(x, h, b22, ldb, c11, ldc);            // P3 = S4 B22
+  multiply(a11, lda, b11, ldb, x, h);            // P1 = A11 B11
+  Combine(h, c12, ldc, x, h, c12, ldc, 1);       // U2 = P1 + P6
+  Combine(h, c21, ldc, c12, ldc, c21, ldc, 1);   // U3 = U2 + P7
+  Combine(h, c12, ldc, c12, ldc, c22, ldc, 1);   // U4 = U2 + P5
+  Combine(h, c22, ldc, c21, ldc, c22, ldc, 1);   // C22 = U3 + P5
+  Combine(h, c12, ldc, c12, ldc, c11, ldc, 1);   // C12 = U4 + P3
+  Combine(h, y, h, y, h, b21, ldb, -1);          // T4 = T2 - B21
+  multiply(a22, lda, y, h, c11, ldc);            // P4 = A22 T4
+  Combine(h, c21, ldc, c21, ldc, c11, ldc, -1);  // C21 = U3 - P4
+  multiply(a12, lda, b21, ldb, c11, ldc);        // P2 = A12 B21
+  Combine(h, c11, ldc, x, h, c11, ldc, 1);       // C11 = P1 + P2
+}
+
+// a (n x n, lda) into the top left of dst (order x order), zeros elsewhere
+void CopyPadded(int n, const double* a, int lda, int order, double* dst) {
+  for (int i = 0; i < order; i++) {
+    double* row = dst + static_cast<std::size_t>(i) * order;
+    int j = 0;
+    if (i < n) {
+      std::memcpy(row, a + static_cast<std::size_t>(i) * lda,
+                  sizeof(double) * n);
+      j = n;
+    }
+    std::fill(row + j, row + order, 0.0);
+  }
+}
+
+}  // namespace
+
+int StrassenOrder(int n, int crossover, int* levels) noexcept {
+  int d = 0;
+  int block = n;
+  while (block > crossover) {
+    d++;
+    block = (n + (1 << d) - 1) >> d;
+  }
+  if (levels != nullptr) *levels = d;
+  return block << d;
+}
+
+std::size_t StrassenWorkspace(int n, int crossover) noexcept {
+  const int order = StrassenOrder(n, crossover);
+  std::size_t total = 0;
+  if (order != n) total += 3 * static_cast<std::size_t>(order) * order;
+  for (int h = order / 2; h * 2 > crossover; h /= 2) {
+    total += 2 * static_cast<std::size_t>(h) * h;
+  }
+  return total;
+}
+
+void StrassenGemm(int n, const double* a, int lda, const double* b, int ldb,
+                  double* c, int ldc, int crossover,
+                  double* workspace) noexcept {
+  const int order = StrassenOrder(n, crossover);
+  if (order == n) {
+    Winograd(n, a, lda, b, ldb, c, ldc, crossover, workspace);
+    return;
+  }
+  const std::size_t size = static_cast<std::size_t>(order) * order;
+  double* pa = workspace;
+  double* pb = pa + size;
+  double* pc = pb + size;
+  CopyPadded(n, a, lda, order, pa);
+  CopyPadded(n, b, ldb, order, pb);
+  Winograd(order, pa, order, pb, order, pc, order, crossover, pc + size);
+  for (int i = 0; i < n; i++) {
+    std::memcpy(c + static_cast<std::size_t>(i) * ldc,
+                pc + static_cast<std::size_t>(i) * order,
+                sizeof(double) * n);
+  }
+}
+
+}  // namespace s21::kernels
+
+void S21Strassen::SetThreshold(int order) noexcept {
+  s21::kernels::strassen_threshold.store(std::max(order, 0));
+}
+
+int S21Strassen::GetThreshold() noexcept {
+  return s21::kernels::strassen_threshold.load();
+}
+
+void S21Strassen::SetCrossover(int order) {
+  if (order < 1) throw std::out_of_range("Error: crossover must be positive");
+  s21::kernels::strassen_crossover.store(order);
+}
+
+int S21Strassen::GetCrossover() noexcept {
+  return s21::kernels::strassen_crossover.load();
+}
+
+double S21Strassen::ErrorBound(int n) noexcept {
+  int levels = 0;
+  const int order = s21::kernels::StrassenOrder(n, GetCrossover(), &levels);
+  const double n0 = static_cast<double>(order >> levels);
+  const double u = std::numeric_limits<double>::epsilon() / 2;
+  return ((n0 * n0 + 6 * n0) * std::pow(18.0, levels) - 6.0 * order) * u;
+}
@@ -0,0 +1,36 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_STRASSEN_H
+#define CPP1_S21_MATRIXPLUS_S21_STRASSEN_H
+
+// Settings of the Strassen-Winograd path of S21Matrix products. A square
+// n x n product with n at or above the threshold is split into 2 x 2
+// blocks and computed from 7 block products instead of 8, recursively,
+// until the blocks are no larger than the crossover order; those go to
+// the blocked GEMM. Orders that do not halve evenly are zero-padded once,
+// at the top. The temporaries of all recursion levels are carved out of a
+// single workspace taken from the current S21MatrixAllocator per product.
+//
+// The result is not bit-identical to the classical product. With d levels
+// of recursion over blocks of order n0, and u the unit roundoff,
+//   max|C - AB| <= ((n0^2 + 6 n0) 18^d - 6n) u max|A| max|B|
+// to first order (Higham, Accuracy and Stability of Numerical Algorithms,
+// 2nd ed., Theorem 23.3); n is the padded order. With the default
+// crossover that is about 4e-8 max|A| max|B| for n = 2048, inside the
+// EqMatrix tolerance for elements of order one, but already 8e-7 for
+// n = 4096: every extra level costs a factor of up to 18.
+//
+// Off by default; S21_MATRIX_STRASSEN=<threshold> in the environment turns
+// it on at startup.
+class S21Strassen {
+ public:
+  // smallest order that takes the fast path; 0 disables it
+  static void SetThreshold(int order) noexcept;
+  static int GetThreshold() noexcept;
+  // largest block order handed to the GEMM; must be positive
+  static void SetCrossover(int order);
+  static int GetCrossover() noexcept;
+  // max|C - AB| / (max|A| max|B|) allowed by the bound above for an n x n
+  // product under the current crossover
+  static double ErrorBound(int n) noexcept;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_STRASSEN_H
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "s21_kernels.h"
+#include "s21_parallel.h"
+
+namespace s21::kernels {
+
+namespace {
+
+struct Job {
+  RangeFn fn;
+  void* ctx;
+  std::atomic<std::size_t> remaining;
+  // most pool workers that may run chunks of the job besides the caller,
+  // or 0 for any number; the first ones to take a chunk keep the seats
+  std::size_t seats;
+  std::mutex seats_mutex;
+  std::vector<std::size_t> seated;
+};
+
+struct Task {
+  Job* job;
+  std::size_t begin, end;
+};
+
+// One deque per worker plus one for outside callers. A worker pops the newest
+// task of its own deque and steals the oldest of the others when it runs dry.
+// A caller waiting for its job only runs chunks of that job: it may hold
+// scratch slots across the call, which a chunk of another caller's job could
+// overwrite.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int workers) : queues_(workers + 1) {
+    for (auto& q : queues_) q = std::make_unique<Queue>();
+    for (int i = 0; i < workers; i++) {
+      threads_.emplace_back([this, i] { WorkerLoop(i + 1); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+  }
+
+  int Threads() const noexcept { return static_cast<int>(queues_.size()); }
+
+  void Run(Job& job, std::size_t count, std::size_t chunks) {
+    const std::size_t step = (count + chunks - 1) / chunks;
+    std::size_t pushed = 0;
+    for (std::size_t b = 0; b < count; b += step) pushed++;
+    job.remaining.store(pushed, std::memory_order_relaxed);
+    // with a limit, only the queues of workers that may hold a seat
+    const std::size_t spread =
+        job.seats == 0 ? queues_.size()
+                       : std::min(queues_.size(), job.seats + 1);
+    std::size_t slot = 0;
+    for (std::size_t b = 0; b < count; b += step, slot++) {
+      Queue& q = *queues_[slot % spread];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      q.tasks.push_back({&job, b, std::min(count, b + step)});
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      generation_++;
+    }
+    wake_.notify_all();
+    while (job.remaining.load(std::memory_order_acquire) != 0) {
+      Task task;
+      if (TakeTask(0, &job, task)) {
+        Execute(task);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // a task for thread self: of job only when it is given, otherwise of any
+  // job with a seat for self
+  bool TakeTask(std::size_t self, Job* only, Task& task) {
+    for (std::size_t i = 0; i < queues_.size(); i++) {
+      Queue& q = *queues_[(self + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      // the newest task of the own deque, the oldest of the others
+      const bool own = i == 0;
+      for (std::size_t k = 0; k < q.tasks.size(); k++) {
+        const std::size_t at = own ? q.tasks.size() - 1 - k : k;
+        Job* job = q.tasks[at].job;
+        if (only != nullptr ? job != only : !Seat(*job, self)) continue;
+        task = q.tasks[at];
+        q.tasks.erase(q.tasks.begin() + static_cast<std::ptrdiff_t>(at));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool Seat(Job& job, std::size_t self) {
+    if (job.seats == 0) return true;
+    std::lock_guard<std::mutex> lock(job.seats_mutex);
+    for (std::size_t seated : job.seated) {
+      if (seated == self) return true;
+    }
+    if (job.seated.size() == job.seats) return false;
+    job.seated.push_back(self);
+    return true;
+  }
+
+  static void Execute(const Task& task) {
+    RunSerially run;
+    task.job->fn(task.job->ctx, task.begin, task.end);
+    task.job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  void WorkerLoop(std::size_t self) {
+    for (;;) {
+      std::size_t seen;
+      {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        seen = generation_;
+      }
+      Task task;
+      if (TakeTask(self, nullptr, task)) {
+        Execute(task);
+        continue;
+      }
+      // nothing this worker may run until another job is posted
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  // bumped whenever tasks are posted
+  std::size_t generation_ = 0;
+  bool stop_ = false;
+};
+
+int DefaultThreadCount() {
+  const char* env = std::getenv("S21_MATRIX_THREADS");
+  if (env != nullptr && std::atoi(env) > 0) return std::atoi(env);
+  int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  return hardware > 0 ? hardware : 1;
+}
+
+std::mutex pool_mutex;
+std::unique_ptr<ThreadPool> pool;
+int thread_count = DefaultThreadCount();
+std::atomic<std::size_t> serial_threshold(1 << 16);
+
+thread_local int thread_limit = 0;
+thread_local bool in_parallel_region = false;
+
+ThreadPool* Pool() {
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  if (pool == nullptr && thread_count > 1) {
+    pool = std::make_unique<ThreadPool>(thread_count - 1);
+  }
+  return pool.get();
+}
+
+}  // namespace
+
+RunSerially::RunSerially() noexcept : previous_(in_parallel_region) {
+  in_parallel_region = true;
+}
+
+RunSerially::~RunSerially() { in_parallel_region = previous_; }
+
+void ParallelForImpl(std::size_t count, std::size_t grain, std::size_t flops,
+                     RangeFn fn, void* ctx) {
+  if (count == 0) return;
+  if (grain == 0) grain = 1;
+  std::size_t threads = 1;
+  ThreadPool* p = nullptr;
+  if (!in_parallel_region && flops >= serial_threshold.load() &&
+      count > grain && thread_limit != 1) {
+    p = Pool();
+    if (p != nullptr) threads = p->Threads();
+    if (thread_limit > 1) {
+      threads = std::min<std::size_t>(threads, thread_limit);
+    }
+  }
+  // a few chunks per thread so that stealing can even out uneven progress
+  std::size_t chunks = std::min(threads * 4, (count + grain - 1) / grain);
+  if (threads <= 1 || chunks <= 1) {
+    fn(ctx, 0, count);
+    return;
+  }
+  Job job{fn, ctx, {0}, thread_limit > 1 ? threads - 1 : 0, {}, {}};
+  p->Run(job, count, chunks);
+}
+
+}  // namespace s21::kernels
+
+void S21Parallel::SetThreadCount(int count) {
+  if (count < 1) {
+    throw std::out_of_range("Error: thread count must be positive");
+  }
+  std::lock_guard<std::mutex> lock(s21::kernels::pool_mutex);
+  if (count != s21::kernels::thread_count) {
+    s21::kernels::pool.reset();
+    s21::kernels::thread_count = count;
+  }
+}
+
+int S21Parallel::GetThreadCount() noexcept {
+  std::lock_guard<std::mutex> lock(s21::kernels::pool_mutex);
+  return s21::kernels::thread_count;
+}
+
+void S21Parallel::SetSerialThreshold(std::size_t flops) noexcept {
+  s21::kernels::serial_threshold.store(flops);
+}
+
+std::size_t S21Parallel::GetSerialThreshold() noexcept {
+  return s21::kernels::serial_threshold.load();
+}
+
+S21ConcurrencyLimit::S21ConcurrencyLimit(int max_threads)
+    : previous_(s21::kernels::thread_limit) {
+  if (max_threads < 1) {
+    throw std::out_of_range("Error: thread limit must be positive");
+  }
+  s21::kernels::thread_limit = max_threads;
+}
+
+S21ConcurrencyLimit::~S21ConcurrencyLimit() {
+  s21::kernels::thread_limit = previous_;
+}
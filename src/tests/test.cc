@@ -1,7 +1,20 @@
 #include <gtest/gtest.h>
-
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "../s21_kernels.h"
 #include "../s21_matrix_oop.h"
 
+constexpr double kEps = S21MatrixTraits<double>::kEpsilon;
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -556,4 +569,1385 @@ TEST(op_braces, True) {
 TEST(braces_out_of_range, True) {
   S21Matrix m(2, 2);
   EXPECT_THROW(m(5, 5), std::out_of_range);
-}
\ No newline at end of file
+}
+TEST(storage_contiguous, True) {
+  S21Matrix m(5, 3);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(m.Data()) %
+                S21Matrix::kAlignment,
+            0u);
+  ASSERT_GE(m.Stride(), m.GetCols());
+  ASSERT_EQ(m.Stride() * sizeof(double) % S21Matrix::kAlignment, 0u);
+  for (int i = 0; i < m.GetRows(); i++) {
+    ASSERT_EQ(m.RowData(i), m.Data() + i * m.Stride());
+    for (int j = 0; j < m.GetCols(); j++) m(i, j) = i * 10 + j;
+  }
+  ASSERT_EQ(m.RowData(3)[2], 32);
+}
+
+TEST(storage_copy_and_resize, True) {
+  S21Matrix m(3, 9);
+  for (int i = 0; i < m.GetRows(); i++)
+    for (int j = 0; j < m.GetCols(); j++) m(i, j) = i * 10 + j;
+  S21Matrix copy(m);
+  ASSERT_NE(copy.Data(), m.Data());
+  ASSERT_TRUE(copy == m);
+  copy.SetCols(5);
+  copy.SetRows(4);
+  ASSERT_EQ(copy.Stride() * sizeof(double) % S21Matrix::kAlignment, 0u);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 5; j++) ASSERT_EQ(copy(i, j), m(i, j));
+  for (int j = 0; j < 5; j++) ASSERT_EQ(copy(3, j), 0);
+  copy.SetCols(0);
+  ASSERT_EQ(copy.GetCols(), 0);
+}
+
+TEST(determinant_small, True) {
+  S21Matrix m(3, 3);
+  m(0, 0) = 2;
+  m(0, 1) = 5;
+  m(0, 2) = 7;
+  m(1, 0) = 6;
+  m(1, 1) = 3;
+  m(1, 2) = 4;
+  m(2, 0) = 5;
+  m(2, 1) = -2;
+  m(2, 2) = -3;
+  ASSERT_NEAR(m.Determinant(), -1, kEps);
+  S21Matrix two(2, 2);
+  two(0, 0) = 3;
+  two(0, 1) = 8;
+  two(1, 0) = 4;
+  two(1, 1) = 6;
+  ASSERT_NEAR(two.Determinant(), -14, kEps);
+}
+
+TEST(determinant_lu, True) {
+  S21Matrix m(4, 4);
+  double values[4][4] = {
+      {1, 3, 5, 9}, {1, 3, 1, 7}, {4, 3, 9, 7}, {5, 2, 0, 9}};
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) m(i, j) = values[i][j];
+  ASSERT_NEAR(m.Determinant(), -376, kEps);
+  int sign = 0;
+  ASSERT_NEAR(m.LogDeterminant(sign), std::log(376.0), kEps);
+  ASSERT_EQ(sign, -1);
+}
+
+TEST(determinant_large, True) {
+  const int n = 60;
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) m(i, j) = (i == j) ? 2 : 0;
+    if (i + 1 < n) m(i, i + 1) = 1;
+  }
+  // upper bidiagonal: det is the product of the diagonal
+  ASSERT_NEAR(m.Determinant() / std::pow(2.0, n), 1, kEps);
+  m.MulNumber(1e12);
+  int sign = 0;
+  ASSERT_NEAR(m.LogDeterminant(sign), n * std::log(2e12), 1e-6);
+  ASSERT_EQ(sign, 1);
+}
+
+TEST(determinant_singular, True) {
+  S21Matrix m(5, 5);
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 5; j++) m(i, j) = i + j;
+  for (int j = 0; j < 5; j++) m(4, j) = 0;
+  ASSERT_EQ(m.Determinant(), 0);
+  int sign = 1;
+  m.LogDeterminant(sign);
+  ASSERT_EQ(sign, 0);
+  EXPECT_THROW(S21Matrix(2, 3).Determinant(), std::invalid_argument);
+}
+
+TEST(inverse_product_is_identity, True) {
+  const int n = 50;
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) m(i, j) = (i == j) ? n : (i * 7 + j * 3) % 11;
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  S21Matrix product = m * m.InverseMatrix();
+  ASSERT_TRUE(product == identity);
+}
+
+TEST(inverse_needs_pivoting, True) {
+  S21Matrix m(3, 3);
+  m(0, 1) = 1;
+  m(1, 2) = 1;
+  m(2, 0) = 1;
+  S21Matrix inverse = m.InverseMatrix();
+  ASSERT_TRUE(inverse == m.Transpose());
+}
+
+TEST(inverse_singular_by_pivot, True) {
+  S21Matrix m(4, 4);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) m(i, j) = 1e-3 * (i + 1) * (j + 1);
+  EXPECT_THROW(m.InverseMatrix(), std::out_of_range);
+  S21Matrix tiny(2, 2);
+  tiny(0, 0) = 1e-12;
+  tiny(1, 1) = 1e-12;
+  ASSERT_NEAR(tiny.InverseMatrix()(1, 1), 1e12, 1);
+}
+
+static S21Matrix NaiveProduct(const S21Matrix& a, const S21Matrix& b) {
+  S21Matrix check(a.GetRows(), b.GetCols());
+  for (int i = 0; i < a.GetRows(); i++)
+    for (int j = 0; j < b.GetCols(); j++)
+      for (int k = 0; k < a.GetCols(); k++) check(i, j) += a(i, k) * b(k, j);
+  return check;
+}
+
+static void FillPattern(S21Matrix& m, int seed) {
+  for (int i = 0; i < m.GetRows(); i++)
+    for (int j = 0; j < m.GetCols(); j++)
+      m(i, j) = ((i * 31 + j * 17 + seed) % 23) * 0.25 - 2;
+}
+
+TEST(gemm_blocked_edges, True) {
+  S21Matrix a(131, 301);
+  S21Matrix b(301, 77);
+  FillPattern(a, 1);
+  FillPattern(b, 2);
+  S21Matrix check = NaiveProduct(a, b);
+  ASSERT_TRUE(a * b == check);
+  a.MulMatrix(b);
+  ASSERT_TRUE(a == check);
+}
+
+TEST(gemm_in_place_square, True) {
+  S21Matrix a(150, 100);
+  S21Matrix b(100, 100);
+  FillPattern(a, 3);
+  FillPattern(b, 4);
+  S21Matrix check = NaiveProduct(a, b);
+  a *= b;
+  ASSERT_TRUE(a == check);
+  S21Matrix self = b;
+  self *= self;
+  ASSERT_TRUE(self == NaiveProduct(b, b));
+}
+
+TEST(simd_levels_agree, True) {
+  using s21::kernels::SimdLevel;
+  const SimdLevel initial = s21::kernels::ActiveSimdLevel();
+  S21Matrix a(37, 29);
+  S21Matrix b(37, 29);
+  FillPattern(a, 5);
+  FillPattern(b, 6);
+  S21Matrix sum(37, 29);
+  S21Matrix transposed(29, 37);
+  for (int i = 0; i < 37; i++) {
+    for (int j = 0; j < 29; j++) {
+      sum(i, j) = (a(i, j) + b(i, j)) * 3 - b(i, j);
+      transposed(j, i) = a(i, j);
+    }
+  }
+  for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2,
+                          SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+    s21::kernels::SetSimdLevel(level);
+    S21Matrix c = a;
+    c.SumMatrix(b);
+    c.MulNumber(3);
+    c.SubMatrix(b);
+    ASSERT_TRUE(c.EqMatrix(sum));
+    c(36, 28) += 1e-6;
+    ASSERT_FALSE(c.EqMatrix(sum));
+    ASSERT_TRUE(a.Transpose().EqMatrix(transposed));
+    S21Matrix bt = b.Transpose();
+    ASSERT_TRUE(a * bt == NaiveProduct(a, bt));
+  }
+  s21::kernels::SetSimdLevel(initial);
+}
+
+TEST(parallel_matches_serial, True) {
+  const int threads = S21Parallel::GetThreadCount();
+  const std::size_t threshold = S21Parallel::GetSerialThreshold();
+  S21Matrix a(203, 190);
+  S21Matrix b(190, 203);
+  FillPattern(a, 7);
+  FillPattern(b, 8);
+  int sign = 0;
+  S21Parallel::SetThreadCount(1);
+  S21Matrix product = a * b;
+  S21Matrix transposed = a.Transpose();
+  S21Matrix square = b * a;
+  for (int i = 0; i < square.GetRows(); i++) square(i, i) += 1000;
+  S21Matrix inverse = square.InverseMatrix();
+  double det = square.LogDeterminant(sign);
+
+  S21Parallel::SetThreadCount(4);
+  S21Parallel::SetSerialThreshold(0);
+  ASSERT_EQ(S21Parallel::GetThreadCount(), 4);
+  ASSERT_TRUE(a * b == product);
+  ASSERT_TRUE(a.Transpose() == transposed);
+  ASSERT_TRUE(square.InverseMatrix() == inverse);
+  ASSERT_DOUBLE_EQ(square.LogDeterminant(sign), det);
+  S21Matrix twice = a;
+  twice.SumMatrix(a);
+  S21Matrix doubled = a * 2.0;
+  ASSERT_TRUE(twice == doubled);
+  twice.SubMatrix(a);
+  ASSERT_TRUE(twice == a);
+  {
+    S21ConcurrencyLimit limit(1);
+    ASSERT_TRUE(a * b == product);
+  }
+  S21Parallel::SetThreadCount(threads);
+  S21Parallel::SetSerialThreshold(threshold);
+}
+
+TEST(parallel_concurrent_callers, True) {
+  const int threads = S21Parallel::GetThreadCount();
+  const std::size_t threshold = S21Parallel::GetSerialThreshold();
+  S21Parallel::SetThreadCount(4);
+  S21Parallel::SetSerialThreshold(0);
+  S21Matrix a(300, 300);
+  FillPattern(a, 6);
+  for (int i = 0; i < 300; i++) a(i, i) += 300;
+  int sign = 0;
+  const double expected = a.LogDeterminant(sign);
+  // the batch inverse keeps the pool busy with chunks of another job while
+  // the determinant holds its scratch across its own parallel calls
+  std::atomic<bool> done{false};
+  std::thread other([&done] {
+    S21MatrixBatch batch(20000, 6, 6);
+    for (int b = 0; b < batch.GetCount(); b++) {
+      for (int i = 0; i < 6; i++) batch(b, i, i) = 1 + b % 5;
+    }
+    S21MatrixBatch::Mask mask;
+    while (!done.load()) batch.InverseMatrix(mask);
+  });
+  int wrong = 0;
+  for (int k = 0; k < 40; k++) {
+    if (a.LogDeterminant(sign) != expected) wrong++;
+  }
+  done.store(true);
+  other.join();
+  S21Parallel::SetThreadCount(threads);
+  S21Parallel::SetSerialThreshold(threshold);
+  ASSERT_EQ(wrong, 0);
+}
+
+TEST(parallel_concurrency_limit, True) {
+  const int threads = S21Parallel::GetThreadCount();
+  S21Parallel::SetThreadCount(4);
+  std::mutex mutex;
+  std::set<std::thread::id> ran;
+  auto record = [&](std::size_t, std::size_t) {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    std::lock_guard<std::mutex> lock(mutex);
+    ran.insert(std::this_thread::get_id());
+  };
+  std::size_t most = 0;
+  {
+    S21ConcurrencyLimit limit(2);
+    for (int k = 0; k < 20; k++) {
+      ran.clear();
+      s21::kernels::ParallelFor(64, 1, std::size_t(1) << 40, record);
+      most = std::max(most, ran.size());
+    }
+  }
+  S21Parallel::SetThreadCount(threads);
+  ASSERT_GE(most, 1u);
+  ASSERT_LE(most, 2u);
+}
+
+TEST(parallel_wrong_settings, True) {
+  EXPECT_THROW(S21Parallel::SetThreadCount(0), std::out_of_range);
+  EXPECT_THROW(S21ConcurrencyLimit limit(0), std::out_of_range);
+}
+
+TEST(expression_fused_in_place, True) {
+  S21Matrix a(40, 30), b(40, 30), c(40, 30), check(40, 30);
+  FillPattern(a, 9);
+  FillPattern(b, 10);
+  FillPattern(c, 11);
+  for (int i = 0; i < 40; i++)
+    for (int j = 0; j < 30; j++) check(i, j) = a(i, j) + b(i, j) - c(i, j) * 2;
+  static_assert(!std::is_same_v<decltype(a + b - c * 2.0), S21Matrix>,
+                "sums and scaling are lazy");
+  S21Matrix d(40, 30);
+  const double* storage = d.Data();
+  d = a + b - c * 2.0;
+  ASSERT_EQ(d.Data(), storage);
+  ASSERT_TRUE(d == check);
+  ASSERT_TRUE(a + b - 2.0 * c == check);
+  d = d - a;
+  d += a;
+  ASSERT_TRUE(d == check);
+  d -= 0.5 * (a + a);
+  ASSERT_TRUE(d + a == check);
+}
+
+TEST(expression_with_products, True) {
+  S21Matrix a(6, 4), b(4, 6), c(6, 6);
+  FillPattern(a, 12);
+  FillPattern(b, 13);
+  FillPattern(c, 14);
+  S21Matrix check = NaiveProduct(a, b);
+  check += c;
+  S21Matrix r = c + a * b;
+  ASSERT_TRUE(r == check);
+  S21Matrix twice = (a + a) * b;
+  ASSERT_TRUE(twice == NaiveProduct(a, b) * 2.0);
+  EXPECT_THROW(S21Matrix(a + b), std::out_of_range);
+  S21Matrix reshaped(2, 2);
+  reshaped = c * 3.0;
+  ASSERT_EQ(reshaped.GetRows(), 6);
+  ASSERT_TRUE(reshaped == 3.0 * c);
+}
+
+TEST(expression_read_only_api, True) {
+  S21Matrix a(3, 3), b(3, 3);
+  for (int i = 0; i < 3; i++) {
+    a(i, i) = 2;
+    b(i, i) = 1;
+    a(0, i) += i;
+  }
+  const S21Matrix sum = NaiveProduct(a, b) * 1.0 + b;
+  ASSERT_EQ((a + b)(0, 2), 2);
+  EXPECT_THROW((a + b)(3, 0), std::out_of_range);
+  ASSERT_TRUE((a + b).EqMatrix(sum));
+  ASSERT_TRUE((a + b) == (b + a));
+  ASSERT_DOUBLE_EQ((a - b).Determinant(), 1);
+  ASSERT_TRUE((a + b).Transpose() == S21Matrix(sum.Transpose()));
+  ASSERT_TRUE((a * 2.0).InverseMatrix() == a.InverseMatrix() * 0.5);
+  ASSERT_TRUE((a - b).CalcComplements() == S21Matrix(a - b).CalcComplements());
+  // the member spellings of the operators still exist
+  const S21Matrix& c = a;
+  ASSERT_TRUE(c.operator+(b) == sum);
+  ASSERT_TRUE(c.operator-(b) == a - b);
+  ASSERT_TRUE(c.operator*(2.0) == operator*(2.0, c));
+}
+
+TEST(assignment_reuses_storage, True) {
+  S21Matrix big(10, 10);
+  S21Matrix small(3, 4);
+  FillPattern(small, 15);
+  const double* storage = big.Data();
+  big = small;
+  ASSERT_EQ(big.Data(), storage);
+  ASSERT_TRUE(big == small);
+  big.SetRows(6);
+  big.SetCols(9);
+  ASSERT_EQ(big.Data(), storage);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 9; j++) {
+      ASSERT_EQ(big(i, j), (i < 3 && j < 4) ? small(i, j) : 0);
+    }
+  }
+  big.SetCols(2);
+  ASSERT_EQ(big(2, 1), small(2, 1));
+  S21Matrix& self = big;
+  big = self;
+  ASSERT_EQ(big.GetCols(), 2);
+}
+
+TEST(shrunk_columns_compare_equal, True) {
+  // 8 and 5 columns share the padded stride, so the rows stay in place
+  S21Matrix wide(3, 8);
+  FillPattern(wide, 4);
+  S21Matrix narrow(3, 5);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 5; j++) narrow(i, j) = wide(i, j);
+  wide.SetCols(5);
+  ASSERT_TRUE(wide == narrow);
+  // growing back reads the cleared columns
+  wide.SetCols(7);
+  ASSERT_EQ(wide(1, 5), 0);
+  ASSERT_EQ(wide(2, 6), 0);
+}
+
+TEST(move_assignment_steals, True) {
+  S21Matrix a(4, 4);
+  S21Matrix b(4, 4);
+  const double* storage = b.Data();
+  a = std::move(b);
+  ASSERT_EQ(a.Data(), storage);
+  ASSERT_EQ(b.Data(), nullptr);
+  ASSERT_EQ(b.GetRows(), 0);
+}
+
+TEST(rvalue_operators_in_place, True) {
+  S21Matrix acc(20, 20), step(20, 20), check(20, 20);
+  FillPattern(step, 16);
+  const double* storage = acc.Data();
+  for (int n = 0; n < 2; n++) {
+    acc = std::move(acc) + step;
+    acc = std::move(acc) * 2.0;
+    acc = step - std::move(acc);
+    acc = std::move(acc) * step;
+    check = (check + step) * 2.0;
+    check = step - check;
+    check = NaiveProduct(check, step);
+    ASSERT_EQ(acc.Data(), storage);
+  }
+  ASSERT_TRUE(acc == check);
+  S21Matrix product = step * step - step;
+  ASSERT_TRUE(product == NaiveProduct(step, step) - step);
+}
+
+TEST(pool_allocator_recycles, True) {
+  S21PoolAllocator pool;
+  S21Matrix a(30, 30), b(30, 30);
+  FillPattern(a, 17);
+  FillPattern(b, 18);
+  S21Matrix check = NaiveProduct(a, b) + a;
+  S21AllocatorScope scope(pool);
+  for (int n = 0; n < 3; n++) {
+    S21Matrix c = a * b + a;
+    ASSERT_TRUE(c == check);
+    if (n == 0) pool.ResetStats();
+  }
+  S21AllocatorStats stats = pool.Stats();
+  ASSERT_EQ(stats.allocations, 2u);
+  ASSERT_EQ(stats.system_allocations, 0u);
+  ASSERT_EQ(stats.bytes_in_use, 0u);
+}
+
+TEST(arena_allocator_reset, True) {
+  S21ArenaAllocator arena(1 << 16);
+  // outlives the arena's contents, so it must own its buffer
+  S21Matrix kept(16, 16);
+  const double* storage = kept.Data();
+  {
+    S21AllocatorScope scope(arena);
+    for (int request = 0; request < 3; request++) {
+      S21Matrix a(16, 16), b(16, 16);
+      FillPattern(a, request);
+      FillPattern(b, request + 1);
+      S21Matrix c = a * b;
+      ASSERT_TRUE(c == NaiveProduct(a, b));
+      ASSERT_EQ(reinterpret_cast<std::uintptr_t>(c.Data()) %
+                    S21Matrix::kAlignment,
+                0u);
+      kept = c;
+      arena.Reset();
+    }
+    ASSERT_EQ(arena.Stats().system_allocations, 1u);
+  }
+  ASSERT_EQ(kept.Data(), storage);
+  ASSERT_EQ(&S21CurrentAllocator(), &S21DefaultAllocator());
+}
+
+TEST(view_writes_reach_parent, True) {
+  S21Matrix a(5, 6);
+  FillPattern(a, 2);
+  S21Matrix before(a);
+  S21MatrixView block = a.Block(1, 2, 3, 3);
+  ASSERT_EQ(block.GetRows(), 3);
+  ASSERT_EQ(block.GetCols(), 3);
+  block(0, 0) = 42;
+  ASSERT_EQ(a(1, 2), 42);
+  block.MulNumber(2);
+  a.Row(4).SumMatrix(before.Row(0));
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 6; j++) {
+      double expected = before(i, j);
+      if (i >= 1 && i < 4 && j >= 2 && j < 5) {
+        expected = (i == 1 && j == 2 ? 42 : expected) * 2;
+      }
+      if (i == 4) expected += before(0, j);
+      ASSERT_DOUBLE_EQ(a(i, j), expected);
+    }
+  }
+  ASSERT_THROW(a.Block(3, 0, 3, 1), std::out_of_range);
+  ASSERT_THROW(block(3, 0), std::out_of_range);
+  ASSERT_THROW(a.Row(0).SumMatrix(a.Col(0)), std::out_of_range);
+}
+
+TEST(view_minor_determinant, True) {
+  S21Matrix a(6, 6);
+  FillPattern(a, 5);
+  for (int i = 0; i < 6; i++) a(i, i) += 10;
+  for (int i = 0; i < 6; i += 5) {
+    for (int j = 0; j < 6; j += 2) {
+      S21MatrixView minor = a.Minor(i, j);
+      S21Matrix copy(minor);
+      ASSERT_EQ(copy.GetRows(), 5);
+      ASSERT_NEAR(minor.Determinant(), copy.Determinant(), 1e-6);
+      ASSERT_TRUE(minor.EqMatrix(copy));
+      // a block of a minor keeps skipping the dropped row and column
+      S21Matrix corner(minor.Block(2, 2, 3, 3));
+      ASSERT_EQ(corner(2, 2), copy(4, 4));
+      ASSERT_NEAR(minor.Block(1, 1, 3, 3).Determinant(),
+                  S21Matrix(copy.Block(1, 1, 3, 3)).Determinant(), 1e-9);
+    }
+  }
+  ASSERT_THROW(a.Minor(0, 0).Minor(0, 0), std::invalid_argument);
+  ASSERT_THROW(a.Block(0, 0, 2, 3).Determinant(), std::invalid_argument);
+}
+
+TEST(view_products_and_sums, True) {
+  S21Matrix a(40, 30), b(30, 50);
+  FillPattern(a, 1);
+  FillPattern(b, 3);
+  S21Matrix product = a.Block(4, 3, 20, 25) * b.Block(3, 7, 25, 13);
+  S21Matrix expected =
+      NaiveProduct(S21Matrix(a.Block(4, 3, 20, 25)),
+                   S21Matrix(b.Block(3, 7, 25, 13)));
+  ASSERT_TRUE(product == expected);
+  ASSERT_TRUE(product.EqMatrix(expected.Block(0, 0, 20, 13)));
+  // minors are gathered before the product
+  ASSERT_TRUE(a.Minor(0, 0).MulMatrix(b.Minor(0, 0)) ==
+              NaiveProduct(S21Matrix(a.Minor(0, 0)), S21Matrix(b.Minor(0, 0))));
+  // the view looks into the matrix being multiplied
+  S21Matrix square(30, 30);
+  FillPattern(square, 7);
+  S21Matrix squared = NaiveProduct(square, square);
+  square.MulMatrix(square.Block(0, 0, 30, 30));
+  ASSERT_TRUE(square == squared);
+  S21Matrix sum(20, 25);
+  sum.SumMatrix(a.Block(4, 3, 20, 25));
+  sum.SubMatrix(a.Block(4, 3, 20, 25));
+  ASSERT_TRUE(sum == S21Matrix(20, 25));
+  ASSERT_FALSE(sum.EqMatrix(a.Block(0, 0, 20, 24)));
+}
+
+TEST(transpose_is_lazy, True) {
+  S21Matrix a(70, 45), b(70, 33);
+  FillPattern(a, 4);
+  FillPattern(b, 9);
+  S21Matrix at(45, 70);
+  for (int i = 0; i < 70; i++) {
+    for (int j = 0; j < 45; j++) at(j, i) = a(i, j);
+  }
+  S21MatrixView view = a.Transpose();
+  ASSERT_EQ(view.GetRows(), 45);
+  ASSERT_EQ(view.GetCols(), 70);
+  ASSERT_EQ(view(3, 60), a(60, 3));
+  ASSERT_TRUE(view == at);
+  ASSERT_TRUE(at == view);
+  ASSERT_TRUE(a.Transpose() * b == NaiveProduct(at, b));
+  ASSERT_TRUE(view.Transpose() == a);
+  S21Matrix sum(at);
+  sum.SumMatrix(view);
+  sum.SubMatrix(a.Transpose());
+  ASSERT_TRUE(sum == at);
+  S21Matrix minor = a.Minor(5, 6).Transpose();
+  ASSERT_TRUE(minor == S21Matrix(a.Minor(5, 6)).Transpose());
+  S21Matrix block = a.Block(0, 0, 10, 10).Transpose();
+  ASSERT_NEAR(block.Determinant(), a.Block(0, 0, 10, 10).Determinant(),
+              1e-6 * std::fabs(block.Determinant()) + 1e-9);
+}
+
+TEST(transpose_aliasing_and_const, True) {
+  S21Matrix a(2, 2);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(1, 0) = 3;
+  a(1, 1) = 4;
+  const S21Matrix c = a;
+  S21Matrix sum(a), difference(a);
+  sum.SumMatrix(sum.Transpose());
+  difference.SubMatrix(difference.Transpose());
+  S21Matrix expected_sum(2, 2), expected_difference(2, 2);
+  expected_sum(0, 0) = 2;
+  expected_sum(0, 1) = 5;
+  expected_sum(1, 0) = 5;
+  expected_sum(1, 1) = 8;
+  expected_difference(0, 1) = -1;
+  expected_difference(1, 0) = 1;
+  ASSERT_TRUE(sum == expected_sum);
+  ASSERT_TRUE(difference == expected_difference);
+  S21Matrix big(40, 40);
+  FillPattern(big, 3);
+  S21Matrix big_sum = big + S21Matrix(big.Transpose());
+  S21Matrix block = big;
+  block.Block(0, 0, 30, 30).SumMatrix(block.Block(5, 5, 30, 30).Transpose());
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 30; j++) {
+      ASSERT_EQ(block(i, j), big(i, j) + big(j + 5, i + 5));
+    }
+  }
+  big.SumMatrix(big.Transpose());
+  ASSERT_TRUE(big == big_sum);
+
+  ASSERT_TRUE(S21Matrix(c + c.Transpose()) == expected_sum);
+  ASSERT_TRUE(S21Matrix(c.Transpose() + c) == expected_sum);
+  ASSERT_TRUE(S21Matrix(c - c.Transpose()) == expected_difference);
+  ASSERT_TRUE(S21Matrix(c.Transpose() - c) ==
+              S21Matrix(expected_difference * -1.0));
+  S21Matrix doubled = c.Transpose() * 2.0;
+  ASSERT_TRUE(doubled == 2.0 * c.Transpose());
+  ASSERT_EQ(doubled(0, 1), 6);
+  ASSERT_TRUE(c.Transpose() * c == NaiveProduct(S21Matrix(c.Transpose()), c));
+  ASSERT_TRUE((c + c) * c.Transpose() ==
+              NaiveProduct(c + c, S21Matrix(c.Transpose())));
+
+  EXPECT_THROW(c.Transpose().MulNumber(2), std::logic_error);
+  EXPECT_THROW(c.Row(0).SumMatrix(c.Row(1)), std::logic_error);
+  EXPECT_THROW(a.Transpose().SubMatrix(c), std::logic_error);
+  ASSERT_EQ(c(0, 0), 1);
+  ASSERT_EQ(c(0, 1), 2);
+  a.Block(0, 0, 1, 1).MulNumber(2);
+  ASSERT_EQ(a(0, 0), 2);
+}
+
+TEST(transpose_in_place, True) {
+  for (int n : {0, 1, 7, 32, 33, 131}) {
+    S21Matrix a(n, n);
+    FillPattern(a, n);
+    S21Matrix expected = a.Transpose();
+    const double* storage = a.Data();
+    a.TransposeInPlace();
+    ASSERT_TRUE(a == expected);
+    ASSERT_EQ(a.Data(), storage);
+  }
+  S21Matrix wide(5, 40);
+  FillPattern(wide, 1);
+  S21Matrix expected = wide.Transpose();
+  wide.TransposeInPlace();
+  ASSERT_EQ(wide.GetRows(), 40);
+  ASSERT_TRUE(wide == expected);
+  S21Matrix square(64, 64);
+  FillPattern(square, 2);
+  S21Matrix product = square * square;
+  S21Matrix expiring = product;
+  const double* storage = expiring.Data();
+  S21Matrix transposed = std::move(expiring).Transpose();
+  ASSERT_TRUE(transposed == product.Transpose());
+  ASSERT_EQ(transposed.Data(), storage);
+}
+
+TEST(basic_matrix_float, True) {
+  S21Matrix a(37, 21), b(21, 29);
+  FillPattern(a, 3);
+  FillPattern(b, 4);
+  S21BasicMatrix<float> af(a), bf(b);
+  // rows are padded to the same 64 bytes, which hold twice as many floats
+  ASSERT_EQ(af.Stride(), 32);
+  ASSERT_EQ(af(5, 7), static_cast<float>(a(5, 7)));
+  S21BasicMatrix<float> product = af * bf;
+  ASSERT_TRUE(product == S21BasicMatrix<float>(a * b));
+  S21BasicMatrix<float> sum = af + af * 2.0f - af;
+  ASSERT_TRUE(sum == 2.0f * af);
+  sum(0, 0) += 1e-3f;
+  ASSERT_FALSE(sum == 2.0f * af);
+  ASSERT_TRUE(af.Transpose().Transpose() == af);
+  S21BasicMatrix<float> square(3, 3);
+  square(0, 0) = 4;
+  square(0, 1) = 1;
+  square(1, 1) = 3;
+  square(2, 0) = 1;
+  square(2, 2) = 2;
+  ASSERT_NEAR(square.Determinant(), 24, 1e-4);
+  S21BasicMatrix<float> identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1;
+  ASSERT_TRUE(square * square.InverseMatrix() == identity);
+}
+
+TEST(basic_matrix_int64_bareiss, True) {
+  // L * U with a unit lower L has det(U) exactly
+  const int n = 10;
+  S21BasicMatrix<std::int64_t> lower(n, n), upper(n, n);
+  std::int64_t expected = 1;
+  for (int i = 0; i < n; i++) {
+    lower(i, i) = 1;
+    upper(i, i) = i + 1;
+    expected *= i + 1;
+    for (int j = 0; j < i; j++) lower(i, j) = (i * 7 + j * 3) % 5 - 2;
+    for (int j = i + 1; j < n; j++) upper(i, j) = (i * 5 + j) % 9 - 4;
+  }
+  S21BasicMatrix<std::int64_t> a = lower * upper;
+  ASSERT_EQ(a.Determinant(), expected);
+  std::swap_ranges(a.RowData(0), a.RowData(0) + n, a.RowData(3));
+  ASSERT_EQ(a.Determinant(), -expected);
+  ASSERT_THROW(a.InverseMatrix(), std::invalid_argument);
+
+  // det(lower) == 1: the inverse is an integer matrix
+  S21BasicMatrix<std::int64_t> inverse = lower.InverseMatrix();
+  S21BasicMatrix<std::int64_t> identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  ASSERT_TRUE(lower * inverse == identity);
+  identity(0, 1) = 1;
+  ASSERT_FALSE(lower * inverse == identity);
+
+  S21BasicMatrix<std::int64_t> singular(3, 3);
+  singular(0, 0) = 1;
+  singular(1, 0) = 2;
+  ASSERT_EQ(singular.Determinant(), 0);
+  ASSERT_THROW(singular.InverseMatrix(), std::out_of_range);
+}
+
+TEST(basic_matrix_complex, True) {
+  using Complex = std::complex<double>;
+  S21BasicMatrix<Complex> m(2, 2);
+  m(0, 0) = Complex(1, 1);
+  m(0, 1) = 2;
+  m(1, 0) = 3;
+  m(1, 1) = Complex(4, -1);
+  const Complex det = m.Determinant();
+  ASSERT_NEAR(det.real(), -1, kEps);
+  ASSERT_NEAR(det.imag(), 3, kEps);
+  S21BasicMatrix<Complex> identity(2, 2);
+  identity(0, 0) = identity(1, 1) = 1;
+  ASSERT_TRUE(m * m.InverseMatrix() == identity);
+  ASSERT_TRUE(m.CalcComplements().Transpose() * (Complex(1) / det) ==
+              m.InverseMatrix());
+  ASSERT_THROW(m * S21BasicMatrix<Complex>(3, 3), std::out_of_range);
+}
+
+template <typename L, typename R, typename = void>
+struct CanMultiply : std::false_type {};
+template <typename L, typename R>
+struct CanMultiply<L, R,
+                   std::void_t<decltype(std::declval<L>() * std::declval<R>())>>
+    : std::true_type {};
+
+TEST(fixed_matrix_constexpr, True) {
+  constexpr S21FixedMatrix<2, 2> m(1, 2, 3, 4);
+  static_assert(m.Determinant() == -2);
+  static_assert(m.Transpose()(0, 1) == 3);
+  constexpr S21FixedMatrix<2, 3> wide(1, 0, 2, 0, 1, 0);
+  constexpr S21FixedMatrix<2, 3> product = m * wide;
+  static_assert(product.At<1, 2>() == 6);
+  static_assert((m * 2.0 - m) == m);
+  static_assert(m.InverseMatrix() * m == S21FixedMatrix<2, 2>::Identity());
+  static_assert(S21FixedMatrix<3, 3>(2, 0, 0, 0, 3, 0, 1, 0, 4).Determinant() ==
+                24);
+  using Fixed23 = S21FixedMatrix<2, 3>;
+  static_assert(CanMultiply<Fixed23, S21FixedMatrix<3, 4>>::value);
+  static_assert(!CanMultiply<Fixed23, Fixed23>::value);
+  static_assert(sizeof(S21FixedMatrix<4, 4>) == 16 * sizeof(double));
+  ASSERT_THROW(m(2, 0), std::out_of_range);
+}
+
+TEST(fixed_matrix_matches_dynamic, True) {
+  S21FixedMatrix<4, 4> f;
+  S21FixedMatrix<3, 3> g;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      f(i, j) = ((i * 5 + j * 3) % 7) - 3 + (i == j ? 6 : 0);
+      if (i < 3 && j < 3) g(i, j) = f(i, j) - (i == j ? 3 : 0);
+    }
+  }
+  using Fixed4 = S21FixedMatrix<4, 4>;
+  using Fixed34 = S21FixedMatrix<3, 4>;
+  const S21Matrix d(f), e(g);
+  ASSERT_NEAR(f.Determinant(), d.Determinant(), 1e-9);
+  ASSERT_NEAR(g.Determinant(), e.Determinant(), 1e-9);
+  ASSERT_TRUE(S21Matrix(f.InverseMatrix()) == d.InverseMatrix());
+  ASSERT_TRUE(S21Matrix(g.InverseMatrix()) == e.InverseMatrix());
+  ASSERT_TRUE(S21Matrix(f.CalcComplements()) == d.CalcComplements());
+  ASSERT_TRUE(S21Matrix(f * f) == d * d);
+  ASSERT_TRUE(Fixed4(d) == f);
+  ASSERT_THROW(Fixed34{d}, std::out_of_range);
+  S21FixedMatrix<2, 2> singular(1, 2, 2, 4);
+  ASSERT_THROW(singular.InverseMatrix(), std::out_of_range);
+}
+
+TEST(batch_matches_per_matrix, True) {
+  for (int n = 2; n <= 5; n++) {
+    S21MatrixBatch batch(37, n, n);
+    for (int b = 0; b < batch.GetCount(); b++) {
+      S21Matrix m(n, n);
+      FillPattern(m, b);
+      for (int i = 0; i < n; i++) m(i, i) += 3 + b % 5;
+      batch.Set(b, m);
+    }
+    // rank one, so singular at every size
+    S21Matrix ones(n, n);
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++) ones(i, j) = 1;
+    batch.Set(20, ones);
+    const std::vector<double> det = batch.Determinant();
+    S21MatrixBatch::Mask singular;
+    const S21MatrixBatch inverse = batch.InverseMatrix(singular);
+    ASSERT_EQ(singular.size(), 37u);
+    for (int b = 0; b < batch.GetCount(); b++) {
+      const S21Matrix m = batch.Get(b);
+      ASSERT_NEAR(det[b], m.Determinant(), 1e-9 * std::fabs(det[b]) + 1e-12);
+      ASSERT_EQ(singular[b] != 0, b == 20);
+      if (b != 20) {
+        ASSERT_TRUE(inverse.Get(b) == m.InverseMatrix());
+      }
+    }
+    ASSERT_TRUE(inverse.Get(20) == S21Matrix(n, n));
+  }
+  S21MatrixBatch rectangular(3, 2, 3);
+  ASSERT_THROW(rectangular.Determinant(), std::invalid_argument);
+  ASSERT_THROW(rectangular(3, 0, 0), std::out_of_range);
+  ASSERT_THROW(rectangular.Set(0, S21Matrix(3, 2)), std::out_of_range);
+}
+
+TEST(batch_mul_and_transpose, True) {
+  S21MatrixBatch a(19, 3, 4), b(19, 4, 2);
+  for (int k = 0; k < a.GetCount(); k++) {
+    S21Matrix x(3, 4), y(4, 2);
+    FillPattern(x, k);
+    FillPattern(y, k + 7);
+    a.Set(k, x);
+    b.Set(k, y);
+  }
+  S21MatrixBatch product(a);
+  product.MulMatrix(b);
+  const S21MatrixBatch transposed = a.Transpose();
+  ASSERT_EQ(product.GetRows(), 3);
+  ASSERT_EQ(product.GetCols(), 2);
+  ASSERT_EQ(transposed.GetRows(), 4);
+  for (int k = 0; k < a.GetCount(); k++) {
+    ASSERT_TRUE(product.Get(k) == NaiveProduct(a.Get(k), b.Get(k)));
+    ASSERT_TRUE(transposed.Get(k) == S21Matrix(a.Get(k).Transpose()));
+  }
+  ASSERT_THROW(a.MulMatrix(a), std::out_of_range);
+  ASSERT_THROW(a.MulMatrix(S21MatrixBatch(18, 4, 2)), std::out_of_range);
+}
+
+// about one element in ten, the rest exact zeros
+static S21Matrix SparsePattern(int rows, int cols, int seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      if ((i * 7 + j * 13 + seed) % 10 == 0) m(i, j) = (i + j + seed) % 5 + 1;
+  return m;
+}
+
+TEST(sparse_conversions, True) {
+  const S21Matrix dense = SparsePattern(23, 17, 3);
+  using Format = S21SparseMatrix::Format;
+  const S21SparseMatrix csr(dense);
+  const S21SparseMatrix csc(dense, 0, Format::kCsc);
+  ASSERT_EQ(csr.Offsets().size(), 24u);
+  ASSERT_EQ(csc.Offsets().size(), 18u);
+  ASSERT_EQ(csr.NonZeros(), csc.NonZeros());
+  ASSERT_TRUE(csr.ToDense() == dense);
+  ASSERT_TRUE(csc.ToDense() == dense);
+  ASSERT_TRUE(csr == csc);
+  ASSERT_TRUE(csr.ToFormat(Format::kCsc).Indices() == csc.Indices());
+  ASSERT_DOUBLE_EQ(csr(4, 4), dense(4, 4));
+  ASSERT_TRUE(csr.Transpose().ToDense() == S21Matrix(dense.Transpose()));
+  // elements within the tolerance are dropped
+  S21Matrix noisy(dense);
+  noisy(0, 1) += 1e-9;
+  ASSERT_EQ(S21SparseMatrix(noisy).NonZeros(), csr.NonZeros());
+  const S21SparseMatrix built = S21SparseMatrix::FromTriplets(
+      2, 3, {{1, 2, 4}, {0, 1, 1}, {1, 2, -1}, {1, 0, 2}});
+  ASSERT_EQ(built.NonZeros(), 3);
+  ASSERT_DOUBLE_EQ(built(1, 2), 3);
+  ASSERT_DOUBLE_EQ(built(0, 0), 0);
+  ASSERT_THROW(S21SparseMatrix::FromTriplets(2, 2, {{2, 0, 1}}),
+               std::out_of_range);
+  ASSERT_THROW(built(2, 0), std::out_of_range);
+}
+
+TEST(sparse_products_and_sums, True) {
+  using Format = S21SparseMatrix::Format;
+  const S21Matrix a = SparsePattern(41, 29, 1), b = SparsePattern(29, 35, 4);
+  S21Matrix x(29, 3);
+  FillPattern(x, 5);
+  const S21SparseMatrix sa(a), sb(b, 0, Format::kCsc);
+  ASSERT_TRUE((sa * sb).ToDense() == NaiveProduct(a, b));
+  ASSERT_TRUE((sb.Transpose() * sa.Transpose()).ToDense() ==
+              S21Matrix(NaiveProduct(a, b).Transpose()));
+  ASSERT_TRUE(sa * x == NaiveProduct(a, x));
+  ASSERT_TRUE(S21Matrix(x.Transpose()) * sb ==
+              NaiveProduct(S21Matrix(x.Transpose()), b));
+  std::vector<double> v(29);
+  for (int j = 0; j < 29; j++) v[j] = j % 4 - 1.5;
+  const std::vector<double> y = sa * v, z = sa.ToFormat(Format::kCsc) * v;
+  for (int i = 0; i < 41; i++) {
+    double expected = 0;
+    for (int j = 0; j < 29; j++) expected += a(i, j) * v[j];
+    ASSERT_NEAR(y[i], expected, 1e-12);
+    ASSERT_NEAR(z[i], expected, 1e-12);
+  }
+  const S21Matrix c = SparsePattern(41, 29, 6);
+  S21SparseMatrix sum = sa + S21SparseMatrix(c, 0, Format::kCsc);
+  ASSERT_TRUE(sum.ToDense() == a + c);
+  sum -= S21SparseMatrix(c);
+  ASSERT_TRUE(sum == sa);
+  sum.Prune();
+  ASSERT_EQ(sum.NonZeros(), sa.NonZeros());
+  ASSERT_TRUE((2.0 * sa).ToDense() == a * 2.0);
+  ASSERT_THROW(sa * sa, std::out_of_range);
+  ASSERT_THROW(sa + sb, std::out_of_range);
+  ASSERT_THROW(sa * std::vector<double>(3), std::out_of_range);
+}
+
+TEST(matrix_file_round_trip, True) {
+  const std::string path = ::testing::TempDir() + "s21_round_trip.bin";
+  S21Matrix a(37, 45);
+  FillPattern(a, 9);
+  S21MatrixFile::Save(path, a);
+  S21Matrix loaded = S21MatrixFile::Load(path);
+  ASSERT_TRUE(loaded == a);
+  ASSERT_EQ(loaded.Stride(), a.Stride());
+  // the mapping is private: writes stay in memory
+  loaded(3, 4) = 100;
+  loaded *= 2.0;
+  ASSERT_TRUE(S21MatrixFile::Load(path) == a);
+  S21MatrixFile file(path);
+  ASSERT_EQ(file.GetHeader().version, S21MatrixFile::kVersion);
+  ASSERT_EQ(file.GetRows(), 37);
+  ASSERT_TRUE(file.View() == a);
+  ASSERT_DOUBLE_EQ(file.View().Block(5, 6, 2, 2)(1, 1), a(6, 7));
+  ASSERT_FALSE(file.View().IsWritable());
+  ASSERT_THROW(file.View().MulNumber(2), std::logic_error);
+  // load, edit and save back to the file the matrix is mapped from
+  S21Matrix big(300, 301);
+  FillPattern(big, 4);
+  S21MatrixFile::Save(path, big);
+  S21Matrix edited = S21MatrixFile::Load(path);
+  edited(0, 0) = 5;
+  S21MatrixFile::Save(path, edited);
+  big(0, 0) = 5;
+  ASSERT_TRUE(edited == big);
+  ASSERT_TRUE(S21MatrixFile::Load(path) == big);
+  S21MatrixFile::Save(path, S21Matrix());
+  ASSERT_EQ(S21MatrixFile::Load(path).GetRows(), 0);
+  std::remove(path.c_str());
+}
+
+TEST(matrix_file_foreign_layouts, True) {
+  const std::string path = ::testing::TempDir() + "s21_col_major.bin";
+  // a 2 x 3 column-major file with unpadded columns
+  S21MatrixFile::Header header = {};
+  std::memcpy(header.magic, S21MatrixFile::kMagic, 8);
+  header.version = 1;
+  header.dtype = S21MatrixFile::DType::kFloat64;
+  header.layout = S21MatrixFile::Layout::kColMajor;
+  header.alignment = 8;
+  header.rows = 2;
+  header.cols = 3;
+  header.stride = 2;
+  header.data_offset = sizeof(header);
+  header.byte_order = S21MatrixFile::kByteOrder;
+  const double elements[] = {1, 4, 2, 5, 3, 6};
+  std::FILE* out = std::fopen(path.c_str(), "wb");
+  std::fwrite(&header, sizeof(header), 1, out);
+  std::fwrite(elements, sizeof(elements), 1, out);
+  std::fclose(out);
+  const S21Matrix loaded = S21MatrixFile::Load(path);
+  ASSERT_EQ(loaded.GetCols(), 3);
+  ASSERT_DOUBLE_EQ(loaded(0, 2), 3);
+  ASSERT_DOUBLE_EQ(loaded(1, 0), 4);
+  ASSERT_DOUBLE_EQ(S21MatrixFile(path).View()(1, 1), 5);
+  // a file cut short is rejected
+  ASSERT_EQ(truncate(path.c_str(), sizeof(header) + 8), 0);
+  ASSERT_THROW(S21MatrixFile::Load(path), std::runtime_error);
+  std::remove(path.c_str());
+  ASSERT_THROW(S21MatrixFile::Load(path), std::runtime_error);
+}
+
+TEST(out_of_core_matches_in_memory, True) {
+  const std::string dir = ::testing::TempDir();
+  S21Matrix a(300, 520), b(520, 270);
+  FillPattern(a, 1);
+  FillPattern(b, 2);
+  a(7, 300) = 1.0 / 3;
+  S21MatrixFile::Save(dir + "s21_ooc_a.bin", a);
+  S21MatrixFile::Save(dir + "s21_ooc_b.bin", b);
+  // 256 x 256 tiles: every dimension is split, the inner one twice
+  const S21OutOfCore engine(S21OutOfCore::MinimumBudget());
+  ASSERT_EQ(engine.TileSize(), 256);
+  engine.MulMatrix(dir + "s21_ooc_a.bin", dir + "s21_ooc_b.bin",
+                   dir + "s21_ooc_c.bin");
+  const S21Matrix c = S21MatrixFile::Load(dir + "s21_ooc_c.bin");
+  S21Matrix expected(a);
+  expected.MulMatrix(b);
+  ASSERT_EQ(c.GetRows(), 300);
+  ASSERT_EQ(c.GetCols(), 270);
+  for (int i = 0; i < 300; i++)
+    for (int j = 0; j < 270; j++) ASSERT_EQ(c(i, j), expected(i, j));
+  ASSERT_THROW(engine.MulMatrix(dir + "s21_ooc_a.bin", dir + "s21_ooc_a.bin",
+                                dir + "s21_ooc_c.bin"),
+               std::out_of_range);
+  // the result may not overwrite an operand, under any of its names
+  const std::string square = dir + "s21_ooc_square.bin";
+  S21Matrix twice(3, 3);
+  for (int i = 0; i < 3; i++) twice(i, i) = 2;
+  S21MatrixFile::Save(square, twice);
+  S21MatrixFile::Save(dir + "s21_ooc_c.bin", twice);
+  ASSERT_THROW(engine.MulMatrix(square, square, square),
+               std::invalid_argument);
+  ASSERT_THROW(engine.MulMatrix(dir + "s21_ooc_c.bin", square,
+                                dir + "./s21_ooc_square.bin"),
+               std::invalid_argument);
+  ASSERT_TRUE(S21MatrixFile::Load(square) == twice);
+  engine.MulMatrix(square, square, dir + "s21_ooc_c.bin");
+  ASSERT_DOUBLE_EQ(S21MatrixFile::Load(dir + "s21_ooc_c.bin")(1, 1), 4);
+  std::remove(square.c_str());
+  ASSERT_THROW(S21OutOfCore(S21OutOfCore::MinimumBudget() - 1),
+               std::invalid_argument);
+  for (const char* name : {"s21_ooc_a.bin", "s21_ooc_b.bin", "s21_ooc_c.bin"})
+    std::remove((dir + name).c_str());
+}
+
+TEST(strassen_error_bound, True) {
+  ASSERT_THROW(S21Strassen::SetCrossover(0), std::out_of_range);
+  // S21_MATRIX_STRASSEN may have set a threshold at startup
+  const int threshold = S21Strassen::GetThreshold();
+  const int crossover = S21Strassen::GetCrossover();
+  S21Strassen::SetThreshold(64);
+  S21Strassen::SetCrossover(32);
+  // 256 halves evenly down to the crossover, 300 is padded to 304
+  for (int n : {256, 300}) {
+    S21Matrix a(n, n), b(n, n);
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++) {
+        a(i, j) = std::sin(i * 0.7 + j * 1.3);
+        b(i, j) = std::cos(i * 1.1 - j * 0.3);
+      }
+    const S21Matrix check = NaiveProduct(a, b);
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    const S21Matrix d = a * b;
+    double error = 0;
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++) {
+        error = std::max(error, std::fabs(c(i, j) - check(i, j)));
+        ASSERT_EQ(c(i, j), d(i, j));
+      }
+    ASSERT_GT(error, 0);
+    ASSERT_LE(error, S21Strassen::ErrorBound(n));
+    ASSERT_LT(S21Strassen::ErrorBound(n), 1e-7);
+    ASSERT_TRUE(c == check);
+  }
+  S21Strassen::SetThreshold(threshold);
+  S21Strassen::SetCrossover(crossover);
+}
+
+TEST(instrumentation_counters, True) {
+  using Ops = std::vector<S21Instrumentation::Operation>;
+  S21Instrumentation::Reset();
+  Ops seen;
+  S21Instrumentation::SetCallback(
+      [&seen](S21Instrumentation::Operation operation, std::uint64_t) {
+        seen.push_back(operation);
+      });
+  S21Matrix a(40, 40);
+  FillPattern(a, 1);
+  for (int i = 0; i < 40; i++) a(i, i) += 100;
+  S21Matrix b(a);
+  b = a;
+  const S21Matrix inverse = a.InverseMatrix();
+  a.SumMatrix(b);
+  S21Matrix sum = a + b;
+  sum += a - b * 2.0;
+  S21Instrumentation::SetCallback(nullptr);
+  const S21Instrumentation::Counters counters = S21Instrumentation::Snapshot();
+  S21Instrumentation::Reset();
+  const S21Instrumentation::Counters cleared = S21Instrumentation::Snapshot();
+  ASSERT_EQ(cleared.element_copies, 0u);
+  ASSERT_EQ(cleared.calls[S21Instrumentation::kCopy], 0u);
+  if (!S21Instrumentation::kEnabled) {
+    ASSERT_EQ(counters.allocations, 0u);
+    ASSERT_TRUE(seen.empty());
+    return;
+  }
+  // InverseMatrix copies the matrix it inverts
+  ASSERT_EQ(counters.element_copies, 3u * 1600);
+  ASSERT_EQ(counters.calls[S21Instrumentation::kCopy], 3u);
+  ASSERT_EQ(counters.calls[S21Instrumentation::kInverseMatrix], 1u);
+  ASSERT_GT(counters.nanoseconds[S21Instrumentation::kInverseMatrix], 0u);
+  ASSERT_EQ(counters.flops[S21Instrumentation::kInvert], 1600u * 79);
+  // SumMatrix, then one flop per element for a + b and three for += a - b * 2
+  ASSERT_EQ(counters.flops[S21Instrumentation::kElementwise], 5u * 1600);
+  ASSERT_EQ(counters.calls[S21Instrumentation::kExpression], 2u);
+  ASSERT_GE(counters.allocations, 4u);
+  ASSERT_GE(counters.allocated_bytes, 4u * 1600 * sizeof(double));
+  ASSERT_EQ(seen, Ops({S21Instrumentation::kCopy, S21Instrumentation::kCopy,
+                       S21Instrumentation::kCopy,
+                       S21Instrumentation::kInverseMatrix,
+                       S21Instrumentation::kSumMatrix,
+                       S21Instrumentation::kExpression,
+                       S21Instrumentation::kExpression}));
+  ASSERT_STREQ(S21Instrumentation::Name(S21Instrumentation::kExpression),
+               "expression");
+  ASSERT_STREQ(S21Instrumentation::Name(S21Instrumentation::kGemm), "gemm");
+}
+
+TEST(lu_factorization_solves, True) {
+  const int n = 150;
+  S21Matrix a(n, n);
+  FillPattern(a, 3);
+  for (int i = 0; i < n; i++) a(i, i) += 1.0 / (i + 1);
+  const S21LuFactorization lu(a);
+  ASSERT_FALSE(lu.IsSingular());
+  ASSERT_NEAR(lu.Determinant() / a.Determinant(), 1, 1e-9);
+  int sign = 0;
+  ASSERT_NEAR(lu.LogDeterminant(sign), a.LogDeterminant(sign), 1e-9);
+  ASSERT_TRUE(lu.InverseMatrix() == a.InverseMatrix());
+  // 1 and 5 columns are swept row by row, 200 go through the blocked path
+  for (int k : {1, 5, 200}) {
+    S21Matrix b(n, k);
+    FillPattern(b, k);
+    const S21Matrix x = lu.Solve(b);
+    ASSERT_TRUE(NaiveProduct(a, x) == b);
+  }
+  std::vector<double> v(n, 1.0);
+  lu.SolveInPlace(v);
+  for (int i = 0; i < n; i++) {
+    double sum = 0;
+    for (int j = 0; j < n; j++) sum += a(i, j) * v[j];
+    ASSERT_NEAR(sum, 1.0, 1e-7);
+  }
+  // caller storage with a leading dimension wider than the block
+  std::vector<double> raw(n * 3, 0);
+  for (int i = 0; i < n; i++) raw[i * 3] = 1.0;
+  lu.SolveInPlace(raw.data(), 1, 3);
+  for (int i = 0; i < n; i++) {
+    ASSERT_DOUBLE_EQ(raw[i * 3], v[i]);
+    ASSERT_EQ(raw[i * 3 + 1], 0);
+  }
+  ASSERT_THROW(lu.Solve(S21Matrix(n + 1, 1)), std::out_of_range);
+  ASSERT_THROW(S21LuFactorization(S21Matrix(2, 3)), std::invalid_argument);
+  S21Matrix singular(3, 3);
+  singular(0, 0) = 1;
+  const S21LuFactorization degenerate(std::move(singular));
+  ASSERT_TRUE(degenerate.IsSingular());
+  ASSERT_EQ(degenerate.Determinant(), 0);
+  ASSERT_THROW(degenerate.Solve(std::vector<double>(3, 1.0)),
+               std::out_of_range);
+  ASSERT_THROW(degenerate.InverseMatrix(), std::out_of_range);
+}
+
+TEST(cholesky_factorization, True) {
+  // B^T B + n I is symmetric positive definite; 150 spans three panels
+  const int n = 150;
+  S21Matrix b(n, n);
+  FillPattern(b, 4);
+  S21Matrix a = NaiveProduct(S21Matrix(b.Transpose()), b);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  const S21CholeskyFactorization chol(a);
+  ASSERT_TRUE(chol.IsPositiveDefinite());
+  const S21Matrix& l = chol.Lower();
+  ASSERT_EQ(l(0, 1), 0);
+  ASSERT_TRUE(NaiveProduct(l, S21Matrix(l.Transpose())) == a);
+  ASSERT_NEAR(chol.LogDeterminant(), [&] {
+    int sign = 0;
+    return a.LogDeterminant(sign);
+  }(), 1e-8);
+  for (int k : {1, 40}) {
+    S21Matrix rhs(n, k);
+    FillPattern(rhs, k);
+    ASSERT_TRUE(NaiveProduct(a, chol.Solve(rhs)) == rhs);
+  }
+  ASSERT_TRUE(chol.InverseMatrix() == a.InverseMatrix());
+  S21Matrix indefinite(2, 2);
+  indefinite(0, 0) = 1;
+  indefinite(1, 0) = 2;
+  indefinite(1, 1) = 1;
+  const S21CholeskyFactorization failed(indefinite);
+  ASSERT_FALSE(failed.IsPositiveDefinite());
+  ASSERT_EQ(failed.Determinant(), 0);
+  ASSERT_THROW(failed.Solve(std::vector<double>(2, 1.0)), std::out_of_range);
+  ASSERT_THROW(S21CholeskyFactorization(S21Matrix(2, 3)),
+               std::invalid_argument);
+}
+
+TEST(qr_least_squares, True) {
+  // 200 x 70: three panels, the last one partial
+  const int m = 200, n = 70;
+  S21Matrix a(m, n);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++) a(i, j) = std::sin((i + 1) * (j + 1) * 0.731);
+  const S21QrFactorization qr(a);
+  ASSERT_TRUE(qr.IsFullRank());
+  const S21Matrix q = qr.Q();
+  const S21Matrix r = qr.R();
+  ASSERT_EQ(r(5, 4), 0);
+  ASSERT_TRUE(NaiveProduct(q, r) == a);
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  ASSERT_TRUE(NaiveProduct(S21Matrix(q.Transpose()), q) == identity);
+  // consistent system: the fit is exact
+  S21Matrix x(n, 3);
+  FillPattern(x, 5);
+  ASSERT_TRUE(qr.Solve(NaiveProduct(a, x)) == x);
+  // inconsistent one: the residual is orthogonal to the columns of A
+  std::vector<double> b(m);
+  for (int i = 0; i < m; i++) b[i] = std::cos(i * 0.5);
+  const std::vector<double> fit = qr.Solve(b);
+  ASSERT_EQ(static_cast<int>(fit.size()), n);
+  for (int j = 0; j < n; j++) {
+    double dot = 0;
+    for (int i = 0; i < m; i++) {
+      double ax = 0;
+      for (int p = 0; p < n; p++) ax += a(i, p) * fit[p];
+      dot += a(i, j) * (b[i] - ax);
+    }
+    ASSERT_NEAR(dot, 0, 1e-9);
+  }
+  ASSERT_THROW(S21QrFactorization(S21Matrix(2, 3)), std::out_of_range);
+  S21Matrix dependent(4, 2);
+  for (int i = 0; i < 4; i++) dependent(i, 0) = dependent(i, 1) = i + 1;
+  const S21QrFactorization deficient(dependent);
+  ASSERT_FALSE(deficient.IsFullRank());
+  ASSERT_THROW(deficient.Solve(std::vector<double>(4, 1.0)),
+               std::out_of_range);
+}
+
+TEST(mixed_precision_refinement, True) {
+  const int n = 120;
+  S21Matrix a(n, n);
+  FillPattern(a, 3);
+  for (int i = 0; i < n; i++) a(i, i) += n;
+  S21MixedPrecisionSolver::ResetGlobalStats();
+  const S21MixedPrecisionSolver solver(a);
+  S21Matrix b(n, 4);
+  FillPattern(b, 7);
+  S21MixedPrecisionSolver::Report report{};
+  const S21Matrix x = solver.Solve(b, &report);
+  ASSERT_FALSE(report.fallback);
+  ASSERT_GE(report.iterations, 1);
+  ASSERT_LE(report.iterations, 5);
+  ASSERT_TRUE(x == S21LuFactorization(a).Solve(b));
+  ASSERT_TRUE(NaiveProduct(a, x) == b);
+  ASSERT_TRUE(solver.InverseMatrix() == a.InverseMatrix());
+  // a Hilbert matrix (condition ~1e13) is out of reach of float factors
+  const int h = 10;
+  S21Matrix hilbert(h, h);
+  for (int i = 0; i < h; i++)
+    for (int j = 0; j < h; j++) hilbert(i, j) = 1.0 / (i + j + 1);
+  const S21MixedPrecisionSolver hard(hilbert);
+  const std::vector<double> ones(h, 1.0);
+  ASSERT_EQ(hard.Solve(ones, &report), S21LuFactorization(hilbert).Solve(ones));
+  ASSERT_TRUE(report.fallback);
+  const S21MixedPrecisionSolver::Stats stats = solver.GetStats();
+  ASSERT_EQ(stats.solves, 2u);
+  ASSERT_EQ(stats.fallbacks, 0u);
+  const S21MixedPrecisionSolver::Stats global =
+      S21MixedPrecisionSolver::GlobalStats();
+  ASSERT_EQ(global.solves, 3u);
+  ASSERT_DOUBLE_EQ(global.FallbackRate(), 1.0 / 3);
+  ASSERT_THROW(S21MixedPrecisionSolver(S21Matrix(2, 3)),
+               std::invalid_argument);
+  ASSERT_THROW(solver.Solve(S21Matrix(n + 1, 1)), std::out_of_range);
+  ASSERT_THROW(S21MixedPrecisionSolver(a, 0), std::out_of_range);
+}
+
+TEST(async_task_graph, True) {
+  using Task = S21Task<S21Matrix>;
+  const int n = 60;
+  S21Matrix a(n, n), b(n, n);
+  FillPattern(a, 2);
+  FillPattern(b, 9);
+  for (int i = 0; i < n; i++) a(i, i) = b(i, i) = n;
+  // independent branches off one product, joined again at the end
+  const Task product = S21Async::MulMatrix(a, b);
+  const Task inverse = S21Async::InverseMatrix(product);
+  const S21Task<double> det = S21Async::Determinant(product);
+  const Task back = S21Async::MulMatrix(product, inverse);
+  const S21Matrix expected = a * b;
+  ASSERT_TRUE(product.Get() == expected);
+  ASSERT_NEAR(det.Get() / expected.Determinant(), 1, 1e-9);
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  ASSERT_TRUE(back.Get() == identity);
+  const S21Task<int> rows = S21Async::Transpose(S21Async::SumMatrix(a, b))
+                                .Then([](const S21Matrix& m) {
+                                  return m.GetRows();
+                                });
+  ASSERT_EQ(rows.Get(), n);
+  // a cancelled task cancels its dependents; the running one finishes
+  std::promise<void> gate;
+  std::shared_future<void> opened = gate.get_future().share();
+  const Task blocked = S21Async::Run([opened] {
+    opened.wait();
+    return S21Matrix(2, 2);
+  });
+  const Task scaled = S21Async::MulNumber(blocked, 2);
+  const Task after = S21Async::Transpose(scaled);
+  ASSERT_FALSE(after.await_ready());
+  std::promise<void> resumed;
+  struct Handle {
+    std::promise<void>* resumed;
+    void resume() { resumed->set_value(); }
+  };
+  ASSERT_TRUE(blocked.await_suspend(Handle{&resumed}));
+  ASSERT_TRUE(scaled.Cancel());
+  ASSERT_TRUE(after.IsCancelled());
+  ASSERT_THROW(after.Get(), std::runtime_error);
+  gate.set_value();
+  resumed.get_future().wait();
+  ASSERT_EQ(blocked.await_resume().GetRows(), 2);
+  ASSERT_FALSE(blocked.Cancel());
+  ASSERT_FALSE(blocked.await_suspend(Handle{nullptr}));
+  // failures reach every dependent with the original exception
+  const Task singular = S21Async::InverseMatrix(S21Matrix(3, 3));
+  ASSERT_THROW(S21Async::Transpose(singular).Get(), std::out_of_range);
+  ASSERT_THROW(S21Async::MulMatrix(Task(), a), std::invalid_argument);
+  ASSERT_THROW(S21Async::SetThreadCount(0), std::out_of_range);
+}
+
+TEST(async_thread_count_swaps, True) {
+  using Task = S21Task<S21Matrix>;
+  S21Matrix a(8, 8);
+  FillPattern(a, 5);
+  for (int round = 0; round < 20; round++) {
+    S21Async::SetThreadCount(4);
+    std::vector<Task> chains;
+    for (int i = 0; i < 8; i++) {
+      chains.push_back(S21Async::MulNumber(S21Async::Transpose(a), 2));
+    }
+    // swapping from inside a task retires the executor that runs it
+    const S21Task<int> swapped = S21Async::Run([round] {
+      S21Async::SetThreadCount(3 + round % 2 * 2);
+      return 0;
+    });
+    const Task after =
+        S21Async::SumMatrix(chains[0], chains[1])
+            .Then([](const S21Matrix& m) { return S21Matrix(m * 0.5); });
+    for (const Task& chain : chains) {
+      ASSERT_TRUE(chain.Get() == S21Matrix(a.Transpose() * 2.0));
+    }
+    ASSERT_EQ(swapped.Get(), 0);
+    ASSERT_TRUE(after.Get() == S21Matrix(a.Transpose() * 2.0));
+    S21Async::SetThreadCount(2);
+  }
+  ASSERT_EQ(S21Async::GetThreadCount(), 2);
+}
+
+TEST(inverse_tracker_updates, True) {
+  const int n = 50;
+  S21Matrix a(n, n);
+  FillPattern(a, 4);
+  for (int i = 0; i < n; i++) a(i, i) = n;
+  S21InverseTracker tracker(a, 0, 1);
+  std::vector<double> row(n), col(n), u(n), v(n);
+  for (int i = 0; i < n; i++) {
+    row[i] = std::sin(i * 0.3);
+    col[i] = std::cos(i * 0.7);
+    u[i] = 0.01 * (i % 7);
+    v[i] = 0.02 * (i % 5) - 0.04;
+  }
+  row[3] = col[8] = n;
+  tracker.SetElement(2, 5, 7.5);
+  tracker.SetRow(3, row);
+  tracker.SetCol(8, col);
+  tracker.RankOneUpdate(u, v);
+  a(2, 5) = 7.5;
+  for (int j = 0; j < n; j++) a(3, j) = row[j];
+  for (int i = 0; i < n; i++) a(i, 8) = col[i];
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) a(i, j) += u[i] * v[j];
+  ASSERT_TRUE(tracker.GetMatrix() == a);
+  ASSERT_TRUE(tracker.GetInverse() == a.InverseMatrix());
+  ASSERT_NEAR(tracker.Determinant() / a.Determinant(), 1, 1e-9);
+  // every update passed the drift check, without refactoring
+  ASSERT_EQ(tracker.GetRefactorCount(), 1u);
+  ASSERT_EQ(tracker.GetDriftFailures(), 0u);
+  // a row copied onto another makes the matrix singular, and back
+  const std::vector<double> saved(a.RowData(1), a.RowData(1) + n);
+  tracker.SetRow(1, std::vector<double>(a.RowData(0), a.RowData(0) + n));
+  ASSERT_TRUE(tracker.IsSingular());
+  ASSERT_EQ(tracker.Determinant(), 0);
+  ASSERT_THROW(tracker.GetInverse(), std::out_of_range);
+  tracker.SetRow(1, saved);
+  ASSERT_FALSE(tracker.IsSingular());
+  ASSERT_TRUE(tracker.GetInverse() == a.InverseMatrix());
+  tracker.SetRefactorInterval(2);
+  const std::uint64_t refactors = tracker.GetRefactorCount();
+  tracker.SetElement(0, 0, n + 1);
+  tracker.SetElement(0, 0, n);
+  ASSERT_EQ(tracker.GetRefactorCount(), refactors + 1);
+  ASSERT_TRUE(tracker.CheckDrift());
+  ASSERT_THROW(tracker.SetElement(n, 0, 1), std::out_of_range);
+  ASSERT_THROW(tracker.SetRow(0, {1.0}), std::out_of_range);
+  ASSERT_THROW(tracker.SetDriftInterval(-1), std::out_of_range);
+  ASSERT_THROW(S21InverseTracker(S21Matrix(2, 3)), std::invalid_argument);
+}